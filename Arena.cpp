@@ -0,0 +1,111 @@
+/**
+ * @file Arena.cpp
+ * @brief Contains the methods of the bump arena used for the scratch memory of a pricing.
+ */
+
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+ /**
+  * @brief Constructs an empty arena.
+  *
+  * No memory is requested until the first allocation.
+  *
+  * @param block_size Size in bytes of the blocks requested from the global allocator.
+  */
+Arena::Arena(size_t block_size) : block_(0), head_(nullptr), end_(nullptr), block_size_(block_size), depth_(0) {}
+
+/**
+ * @brief Moves the bump pointer to the first block able to hold the request.
+ *
+ * Blocks already owned by the arena are reused before a new one is requested; a new block
+ * is at least `block_size_` bytes, or larger if the request itself does not fit.
+ *
+ * @param bytes Number of bytes (alignment slack included) that must fit in the block.
+ */
+void Arena::next_block(size_t bytes) {
+    size_t ii = head_ ? block_ + 1 : 0;
+    for (; ii < blocks_.size(); ii++) {
+        if (sizes_[ii] >= bytes) break;
+    }
+    if (ii == blocks_.size()) {
+        size_t size = std::max(block_size_, bytes);
+        blocks_.emplace_back(new char[size]);
+        sizes_.push_back(size);
+    }
+    block_ = ii;
+    head_ = blocks_[ii].get();
+    end_ = head_ + sizes_[ii];
+}
+
+/**
+ * @brief Allocates memory by bumping the pointer of the current block.
+ *
+ * If the current block cannot hold the request, the pointer moves to the next suitable block.
+ *
+ * @param bytes Number of bytes requested.
+ * @param alignment Required alignment, a power of two.
+ * @return Pointer to the allocated memory.
+ */
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(head_) + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+    if (!head_ || p + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+        next_block(bytes + alignment);
+        p = (reinterpret_cast<std::uintptr_t>(head_) + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+    }
+    head_ = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+/**
+ * @brief Releases everything allocated after the given marker.
+ * @param marker Position previously returned by `mark`.
+ */
+void Arena::rewind(const Marker& marker) {
+    block_ = marker.block;
+    head_ = marker.head;
+    end_ = head_ ? blocks_[block_].get() + sizes_[block_] : nullptr;
+}
+
+/**
+ * @brief Releases every allocation, keeping the blocks for reuse.
+ */
+void Arena::reset() {
+    block_ = 0;
+    head_ = blocks_.empty() ? nullptr : blocks_[0].get();
+    end_ = blocks_.empty() ? nullptr : head_ + sizes_[0];
+}
+
+/**
+ * @brief Checks whether a pointer was handed out by this arena.
+ * @param p Pointer to check.
+ * @return True if `p` lies in one of the arena blocks.
+ */
+bool Arena::owns(const void* p) const {
+    const char* c = static_cast<const char*>(p);
+    for (size_t ii = 0; ii < blocks_.size(); ii++) {
+        if (c >= blocks_[ii].get() && c < blocks_[ii].get() + sizes_[ii]) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the total size of the blocks held by the arena.
+ * @return Capacity in bytes.
+ */
+size_t Arena::capacity() const {
+    size_t res = 0;
+    for (size_t size : sizes_) res += size;
+    return res;
+}
+
+/**
+ * @brief Returns the arena of the calling thread.
+ * @return Thread-local arena.
+ */
+Arena& Arena::local() {
+    thread_local Arena arena;
+    return arena;
+}
\ No newline at end of file
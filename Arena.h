@@ -0,0 +1,201 @@
+/**
+ * @file Arena.h
+ * @brief Thread-local bump arena for the scratch memory of a pricing, and the allocator drawing from it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * @class Arena
+ * @brief Bump allocator over a list of memory blocks.
+ *
+ * Memory is handed out by advancing a pointer inside the current block; nothing is freed
+ * individually. Releasing everything is a pointer reset, and blocks are kept for the next pricing,
+ * so a warmed-up arena never goes back to the global allocator.
+ *
+ * Each thread owns its own arena (see `Arena::local()`), so concurrent pricings never contend on a lock.
+ */
+class Arena {
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<size_t> sizes_;
+    size_t block_;
+    char* head_;
+    char* end_;
+    size_t block_size_;
+    unsigned int depth_;
+
+    void next_block(size_t bytes);
+
+public:
+    /**
+     * @brief Position of the bump pointer, used to release everything allocated after it.
+     */
+    struct Marker {
+        size_t block;
+        char* head;
+    };
+
+    /**
+     * @brief Constructs an empty arena.
+     * @param block_size Size in bytes of the blocks requested from the global allocator.
+     */
+    explicit Arena(size_t block_size = 1 << 20);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocates memory by bumping the pointer of the current block.
+     * @param bytes Number of bytes requested.
+     * @param alignment Required alignment, a power of two.
+     * @return Pointer to the allocated memory.
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief Returns the current position of the bump pointer.
+     * @return Marker to pass to `rewind`.
+     */
+    Marker mark() const { return Marker{ block_, head_ }; }
+
+    /**
+     * @brief Releases everything allocated after the given marker.
+     * @param marker Position previously returned by `mark`.
+     */
+    void rewind(const Marker& marker);
+
+    /**
+     * @brief Releases every allocation, keeping the blocks for reuse.
+     */
+    void reset();
+
+    /**
+     * @brief Checks whether a pointer was handed out by this arena.
+     * @param p Pointer to check.
+     * @return True if `p` lies in one of the arena blocks.
+     */
+    bool owns(const void* p) const;
+
+    /**
+     * @brief Returns the total size of the blocks held by the arena.
+     * @return Capacity in bytes.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Tells whether an `ArenaScope` is open on the arena.
+     * @return True while allocations are served by the arena.
+     */
+    bool active() const { return depth_ > 0; }
+
+    /**
+     * @brief Returns the arena of the calling thread.
+     * @return Thread-local arena.
+     */
+    static Arena& local();
+
+    friend class ArenaScope;
+};
+
+/**
+ * @class ArenaScope
+ * @brief RAII scope during which `ArenaAllocator` allocations are served by the thread-local arena.
+ *
+ * Scopes nest: leaving a scope releases everything allocated since it was opened, and leaving
+ * the outermost scope resets the arena. A pricing opens one scope around the whole solve and one
+ * per time step, so the scratch memory of a step is reused by the next one.
+ *
+ * Vectors allocated inside a scope must not be used after it is closed; they may still be destroyed,
+ * on any thread.
+ */
+class ArenaScope {
+
+    Arena& arena_;
+    Arena::Marker marker_;
+
+public:
+    /**
+     * @brief Opens a scope on the arena of the calling thread.
+     */
+    ArenaScope() : arena_(Arena::local()), marker_(arena_.mark()) { arena_.depth_++; }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /**
+     * @brief Closes the scope, releasing the memory allocated inside it.
+     */
+    ~ArenaScope() {
+        if (--arena_.depth_ == 0) arena_.reset();
+        else arena_.rewind(marker_);
+    }
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Standard allocator drawing from the thread-local arena while an `ArenaScope` is open.
+ *
+ * Outside of any scope it falls back to the global allocator, so containers using it behave as
+ * ordinary containers when the caller does not opt in. Each allocation is tagged, just before the
+ * storage handed out, with the arena it came from, or null for the global allocator:
+ * deallocation reads the tag instead of asking the arena of the calling thread, so a vector can be
+ * freed on another thread, or after its scope was closed. Deallocation of arena memory is a no-op.
+ */
+template <class T>
+class ArenaAllocator {
+    /**
+     * @brief Bytes reserved before the storage for the tag, a multiple of the alignment of `T`.
+     */
+    static size_t header() { return alignof(T) > sizeof(Arena*) ? alignof(T) : sizeof(Arena*); }
+
+public:
+    typedef T value_type;
+
+    ArenaAllocator() {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    /**
+     * @brief Allocates storage for `n` objects.
+     * @param n Number of objects.
+     * @return Pointer to uninitialized storage.
+     */
+    T* allocate(size_t n) {
+        Arena& arena = Arena::local();
+        Arena* origin = arena.active() ? &arena : nullptr;
+        size_t bytes = header() + n * sizeof(T);
+        char* base = static_cast<char*>(origin ? arena.allocate(bytes, header()) : ::operator new(bytes));
+        char* p = base + header();
+        reinterpret_cast<Arena**>(p)[-1] = origin;
+        return reinterpret_cast<T*>(p);
+    }
+
+    /**
+     * @brief Releases storage previously obtained from `allocate`, on any thread.
+     * @param p Pointer to the storage.
+     */
+    void deallocate(T* p, size_t) {
+        char* c = reinterpret_cast<char*>(p);
+        if (!reinterpret_cast<Arena**>(c)[-1]) {
+            ::operator delete(c - header());
+        }
+    }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) { return true; }
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) { return false; }
+
+/**
+ * @brief Vector of doubles used for the scratch memory of a pricing.
+ */
+typedef std::vector<double, ArenaAllocator<double>> ScratchVector;
\ No newline at end of file
@@ -0,0 +1,344 @@
+/**
+ * @file AsianOption.cpp
+ * @brief Contains the methods of the discretely averaged Asian option pricer.
+ */
+
+#include "AsianOption.h"
+#include "Arena.h"
+#include "ThreadPool.h"
+#include "Tridiag.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Minimum number of spot lines per task of the parallel loops.
+     */
+    const size_t LINE_GRAIN = 8;
+
+    /**
+     * @brief Quadratic Lagrange weights on the nodes \( m - 1, m, m + 1 \), or their derivatives.
+     * @param t Position relative to node \( m \), in steps.
+     * @param order Order of the derivative (0, 1 or 2), per step.
+     * @param w Output weights.
+     */
+    void lagrange(double t, int order, double* w) {
+        if (order == 0) {
+            w[0] = t * (t - 1) / 2;
+            w[1] = 1 - t * t;
+            w[2] = t * (t + 1) / 2;
+        }
+        else if (order == 1) {
+            w[0] = t - 0.5;
+            w[1] = -2 * t;
+            w[2] = t + 0.5;
+        }
+        else {
+            w[0] = 1;
+            w[1] = -2;
+            w[2] = 1;
+        }
+    }
+
+    /**
+     * @brief Returns the nearest interior node of a line, so that the three-point stencil around it stays on the line.
+     * @param x Position, in steps.
+     * @param steps Number of steps of the line.
+     * @return Node between 1 and `steps - 1`.
+     */
+    size_t centre(double x, size_t steps) {
+        return static_cast<size_t>(std::min<double>(std::max<double>(std::round(x), 1), steps - 1));
+    }
+}
+
+// Definition of the in-class constant, which std::min binds to a reference.
+const size_t AsianOption::TILE;
+
+/**
+ * @brief Constructs and prices an Asian option.
+ * @param contract_type Type of option: 1 for Call, -1 for Put.
+ * @param strike_type Fixed or floating strike.
+ * @param T Maturity time.
+ * @param K Strike price; ignored for a floating strike.
+ * @param T0 Start time.
+ * @param time_mesh Number of time steps.
+ * @param spot_mesh Number of spot steps.
+ * @param average_mesh Number of average steps.
+ * @param S0 Current spot price.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param volatility Volatility of the underlying.
+ * @param averaging Fixing schedule.
+ * @param yield Continuous dividend yield.
+ * @param S_max Upper bound of the spot and average grids; 0 uses \( 5 S_0 \).
+ */
+AsianOption::AsianOption(int contract_type, AsianStrike strike_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh,
+    unsigned int average_mesh, double S0, InterestRateHandle rate_curve, double volatility, const Averaging& averaging, double yield, double S_max)
+    : contract_type_(contract_type), strike_type_(strike_type), T_(T), K_(K), T0_(T0), time_mesh_(time_mesh), spot_mesh_(spot_mesh),
+    average_mesh_(average_mesh), S0_(S0), S_max_(S_max > 0 ? S_max : 5 * S0), sigma_(volatility), yield_(yield), averaging_(averaging),
+    curve(std::move(rate_curve)) {
+    setup();
+}
+
+/**
+ * @brief Validates the parameters, sets up the mesh, assigns the fixings to time steps and prices the option.
+ */
+void AsianOption::setup() {
+    if (contract_type_ != 1 && contract_type_ != -1) throw InvalidContractType(contract_type_);
+    if (T_ <= T0_ || T_ < 0) throw InvalidMaturity();
+    if (strike_type_ == AsianStrike::Fixed && K_ <= 0) throw InvalidStrike(K_);
+    if (time_mesh_ <= 0) throw InvalidTimeMesh(time_mesh_);
+    if (spot_mesh_ < 3) throw InvalidSpotMesh(spot_mesh_);
+    if (S0_ <= 0) throw InvalidSpot(S0_);
+    if (!(sigma_ > 0)) throw InvalidVolatility(sigma_);
+    if (S_max_ <= S0_) throw InvalidDomain(S_max_);
+    if (average_mesh_ < 2) throw InvalidAverage(average_mesh_);
+    if (averaging_.fixings.empty() && averaging_.past_fixings == 0) throw InvalidAverage(0);
+    if (averaging_.past_fixings > 0 && !(averaging_.past_average >= 0 && averaging_.past_average <= S_max_)) throw InvalidAverage(averaging_.past_average);
+
+    dT = (T_ - T0_) / time_mesh_;
+    dS = S_max_ / spot_mesh_;
+    dA = S_max_ / average_mesh_;
+    fixing_levels_.clear();
+    for (double t : averaging_.fixings) {
+        if (!(t >= 0 && t <= T_ - T0_)) throw InvalidSchedule(t);
+        fixing_levels_.push_back(std::min<size_t>(static_cast<size_t>(std::round((T_ - T0_ - t) / dT)), time_mesh_));
+    }
+    std::sort(fixing_levels_.begin(), fixing_levels_.end());
+    solve();
+}
+
+/**
+ * @brief Returns the payoff at maturity.
+ * @param S Spot price.
+ * @param A Average of all the fixings.
+ * @return Exercise value.
+ */
+double AsianOption::payoff(double S, double A) const {
+    double underlying = strike_type_ == AsianStrike::Fixed ? A - K_ : S - A;
+    return std::max(contract_type_ * underlying, 0.0);
+}
+
+/**
+ * @brief Writes the Dirichlet values of the boundary \( S = S_{max} \) at a time step.
+ *
+ * With \( m \) fixings observed and the remaining ones at \( t_k \), the expected average is
+ * \( \mathbb{E}[A_T] = (m A + S \sum_k G(t, t_k)) / n \), \( G \) being the growth factor of the
+ * forward; the boundary value is the discounted payoff of the expected average (and of the forward
+ * of \( S_T \) for a floating strike).
+ *
+ * @param u Grid values.
+ * @param n Time step, counted back from maturity.
+ * @param done Number of future fixings applied by the backward sweep so far, all after step \( n \).
+ */
+void AsianOption::set_boundary(double* u, size_t n, size_t done) const {
+    double t = T_ - T0_ - n * dT;
+    double growth = 0;
+    for (size_t kk = 0; kk < done; kk++) {
+        double tk = T_ - T0_ - fixing_levels_[kk] * dT;
+        growth += std::exp(curve->integral(t) - curve->integral(tk) - yield_ * (tk - t));
+    }
+    double total = static_cast<double>(averaging_.past_fixings + fixing_levels_.size());
+    double observed = total - done;
+    double disc = std::exp(-(curve->integral(t) - curve->integral(T_ - T0_)));
+    double forward = S_max_ * std::exp(-yield_ * (T_ - T0_ - t)) / disc;
+
+    double* edge = u + spot_mesh_ * lanes_;
+    size_t active = flat_ ? 1 : lanes_;
+    for (size_t ll = 0; ll < active; ll++) {
+        double average = (observed * ll * dA + S_max_ * growth) / total;
+        edge[ll] = disc * payoff(forward, average);
+    }
+}
+
+/**
+ * @brief Takes one Crank-Nicolson step on every line of constant average.
+ *
+ * The operator \( \tfrac{1}{2} \sigma^2 S^2 \partial_{SS} + (r - q) S \partial_S - r \) does not depend
+ * on \( A \): the matrix is built once, at the rate of the middle of the step, and each tile of
+ * `TILE` average lines is solved with one call of `Tridiag::solve_lanes`.
+ *
+ * @param u Values at step \( n \).
+ * @param y Values at step \( n + 1 \).
+ * @param n Time step, counted back from maturity.
+ */
+void AsianOption::step(const double* u, double* y, size_t n) const {
+    ArenaScope lines;
+    size_t rows = spot_mesh_;
+    size_t active = flat_ ? 1 : lanes_;
+    double r = (*curve)(T_ - T0_ - (n + 0.5) * dT);
+    double w = dT / 2;
+    auto coefficients = [&](size_t ii, double& a, double& b) {
+        a = 0.5 * sigma_ * sigma_ * ii * ii;
+        b = 0.5 * (r - yield_) * ii;
+    };
+
+    Tridiag C(ScratchVector(rows - 1), ScratchVector(rows), ScratchVector(rows - 1));
+    for (size_t ii = 0; ii < rows; ii++) {
+        double a, b;
+        coefficients(ii, a, b);
+        if (ii > 0) C.subdiag()[ii - 1] = -w * (a - b);
+        C.diag()[ii] = 1 + w * (2 * a + r);
+        if (ii < rows - 1) C.superdiag()[ii] = -w * (a + b);
+    }
+
+    ThreadPool::global().parallel_for(0, rows, [&](size_t lo, size_t hi) {
+        for (size_t ii = lo; ii < hi; ii++) {
+            double a, b;
+            coefficients(ii, a, b);
+            const double* x = u + ii * lanes_;
+            double* res = y + ii * lanes_;
+            for (size_t ll = 0; ll < active; ll++) {
+                double f = -(2 * a + r) * x[ll];
+                if (ii > 0) f += (a - b) * x[ll - lanes_] + (a + b) * x[ll + lanes_];
+                res[ll] = x[ll] + w * f;
+            }
+        }
+    }, LINE_GRAIN);
+
+    size_t done = std::upper_bound(fixing_levels_.begin(), fixing_levels_.end(), n) - fixing_levels_.begin();
+    set_boundary(y, n + 1, done);
+    double a, b;
+    coefficients(rows - 1, a, b);
+    double* last = y + (rows - 1) * lanes_;
+    for (size_t ll = 0; ll < active; ll++) {
+        last[ll] += w * (a + b) * last[ll + lanes_];
+    }
+
+    size_t tiles = (active + TILE - 1) / TILE;
+    ThreadPool::global().parallel_for(0, tiles, [&](size_t lo, size_t hi) {
+        for (size_t tt = lo; tt < hi; tt++) {
+            size_t first = tt * TILE;
+            C.solve_lanes(y + first, std::min(TILE, active - first), lanes_);
+        }
+    });
+}
+
+/**
+ * @brief Applies the jump condition of the \( m \)-th fixing.
+ *
+ * Each spot line is interpolated quadratically at the averages \( A + (S - A) / m \). For \( m = 1 \) the
+ * new average is \( S \) whatever \( A \), so only the first average line is written.
+ *
+ * @param u Grid values, overwritten.
+ * @param m Number of fixings observed once this one is included.
+ */
+void AsianOption::fix(double* u, double m) const {
+    size_t active = m == 1 ? 1 : lanes_;
+    ThreadPool::global().parallel_for(0, spot_mesh_ + 1, [&](size_t lo, size_t hi) {
+        std::vector<double> line(lanes_);
+        for (size_t ii = lo; ii < hi; ii++) {
+            double* row = u + ii * lanes_;
+            std::copy(row, row + lanes_, line.begin());
+            double S = ii * dS;
+            for (size_t ll = 0; ll < active; ll++) {
+                double A = ll * dA;
+                double p = (A + (S - A) / m) / dA;
+                size_t k = centre(p, average_mesh_);
+                double w[3];
+                lagrange(p - k, 0, w);
+                row[ll] = w[0] * line[k - 1] + w[1] * line[k] + w[2] * line[k + 1];
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Runs the backward sweep from the payoff to the initial time.
+ *
+ * The fixings of a time step are applied after the step reaches it, latest first; the count of
+ * observed fixings goes down from the total to the past fixings. The fixings at maturity act on
+ * the payoff itself, so they are evaluated exactly rather than interpolated across its kink.
+ */
+void AsianOption::solve() {
+    lanes_ = average_mesh_ + 1;
+    flat_ = false;
+    size_t size = (spot_mesh_ + 1) * lanes_;
+    std::vector<double> u(size), y(size);
+
+    size_t next = std::upper_bound(fixing_levels_.begin(), fixing_levels_.end(), 0) - fixing_levels_.begin();
+    double m = static_cast<double>(averaging_.past_fixings + fixing_levels_.size());
+    for (size_t ii = 0; ii <= spot_mesh_; ii++) {
+        double S = ii * dS;
+        for (size_t ll = 0; ll < lanes_; ll++) {
+            double A = ll * dA;
+            for (size_t kk = 0; kk < next; kk++) A += (S - A) / (m - kk);
+            u[ii * lanes_ + ll] = payoff(S, A);
+        }
+    }
+    m -= next;
+    flat_ = m == 0;
+
+    for (size_t nn = 0; nn < time_mesh_; nn++) {
+        step(u.data(), y.data(), nn);
+        u.swap(y);
+        for (; next < fixing_levels_.size() && fixing_levels_[next] == nn + 1; next++, m -= 1) {
+            fix(u.data(), m);
+            if (m == 1) flat_ = true;
+        }
+    }
+    grid = std::move(u);
+}
+
+/**
+ * @brief Interpolates the grid values, or their derivatives in \( S \), with quadratic Lagrange polynomials.
+ * @param S Spot price.
+ * @param A Average of the past fixings; ignored once the value no longer depends on it.
+ * @param order Order of the derivative in \( S \) (0, 1 or 2).
+ * @return Interpolated value or derivative.
+ */
+double AsianOption::interpolate(double S, double A, int order) const {
+    double xs = S / dS, xa = A / dA;
+    size_t ms = centre(xs, spot_mesh_);
+    size_t ma = centre(xa, average_mesh_);
+    double ws[3], wa[3] = { 0, 0, 0 };
+    lagrange(xs - ms, order, ws);
+    if (flat_) {
+        ma = 1;
+        wa[0] = 1;
+    }
+    else {
+        lagrange(xa - ma, 0, wa);
+    }
+
+    double res = 0;
+    for (size_t ii = 0; ii < 3; ii++) {
+        const double* row = grid.data() + (ms - 1 + ii) * lanes_;
+        res += ws[ii] * (wa[0] * row[ma - 1] + wa[1] * row[ma] + wa[2] * row[ma + 1]);
+    }
+    return res / std::pow(dS, order);
+}
+
+/**
+ * @brief Returns the option value at any point of the grid domain.
+ * @param S Spot price.
+ * @param A Average of the past fixings; ignored when none has been observed.
+ * @return Interpolated value at \( T_0 \).
+ */
+double AsianOption::value(double S, double A) const {
+    return interpolate(S, A, 0);
+}
+
+/**
+ * @brief Returns the price of the option.
+ * @return Value at \( S_0 \) and the past average, at \( T_0 \).
+ */
+double AsianOption::price() const {
+    return value(S0_, averaging_.past_average);
+}
+
+/**
+ * @brief Returns the delta of the option.
+ * @return \( \partial V / \partial S \) at \( S_0 \) and the past average.
+ */
+double AsianOption::delta() const {
+    return interpolate(S0_, averaging_.past_average, 1);
+}
+
+/**
+ * @brief Returns the gamma of the option.
+ * @return \( \partial^2 V / \partial S^2 \) at \( S_0 \) and the past average.
+ */
+double AsianOption::gamma() const {
+    return interpolate(S0_, averaging_.past_average, 2);
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**
+ * @file AsianOption.h
+ * @brief Finite difference pricer for discretely averaged arithmetic Asian options on an \( (S, A) \) grid.
+ */
+
+#pragma once
+
+#include "InterestRate.h"
+#include "OptionExceptions.h"
+
+#include <vector>
+
+/**
+ * @brief Strike of an Asian option with contract type \( \phi = \pm 1 \) and average \( A_T \).
+ */
+enum class AsianStrike {
+    Fixed,   ///< \( \max(\phi (A_T - K), 0) \).
+    Floating ///< \( \max(\phi (S_T - A_T), 0) \).
+};
+
+/**
+ * @brief Fixing schedule of an Asian option.
+ */
+struct Averaging {
+    std::vector<double> fixings; ///< Future fixing times, on the clock of the curve (between 0 and \( T - T_0 \)).
+    double past_average;         ///< Arithmetic average of the fixings already observed.
+    unsigned int past_fixings;   ///< Number of fixings already observed.
+
+    /**
+     * @brief Constructs a fixing schedule.
+     * @param fixings Future fixing times.
+     * @param past_average Average of the fixings already observed.
+     * @param past_fixings Number of fixings already observed.
+     */
+    Averaging(std::vector<double> fixings = std::vector<double>(), double past_average = 0, unsigned int past_fixings = 0)
+        : fixings(std::move(fixings)), past_average(past_average), past_fixings(past_fixings) {}
+};
+
+/**
+ * @class AsianOption
+ * @brief Prices a European arithmetic Asian option with discrete fixings on a uniform \( (S, A) \) grid.
+ *
+ * The running average \( A \) only changes at the fixings, so between two fixings the value solves
+ * the one-dimensional Black-Scholes equation in \( S \) on every line of constant \( A \). These
+ * lines share the same operator: each Crank-Nicolson step builds one tridiagonal matrix and solves
+ * all the average lines as the lanes of `Tridiag::solve_lanes`, the grid being stored spot line by
+ * spot line with the averages contiguous, in tiles split across `ThreadPool::global()`.
+ *
+ * At the \( m \)-th fixing at \( t_k \) the average jumps, which gives the jump condition
+ * \[
+ * V(S, A, t_k^-) = V\left(S, A + \frac{S - A}{m}, t_k^+\right),
+ * \]
+ * applied by quadratic interpolation along \( A \). The new average is a convex combination of \( A \)
+ * and \( S \), so it stays on the grid when \( A_{max} = S_{max} \). After the first fixing in the
+ * backward sweep (the first one of the contract) the value no longer depends on \( A \), and the
+ * remaining steps only solve one line.
+ *
+ * On \( S = 0 \) the equation degenerates and the node is solved with it; on \( S_{max} \) the value
+ * is the discounted payoff of the expected average, \( \mathbb{E}[A_T] \) being linear in \( S \) and
+ * \( A \). Fixing times are snapped to the nearest time step.
+ */
+class AsianOption {
+    int contract_type_;
+    AsianStrike strike_type_;
+    double T_;
+    double K_;
+    double T0_;
+    unsigned int time_mesh_;
+    unsigned int spot_mesh_;
+    unsigned int average_mesh_;
+    double S0_;
+    double S_max_;
+    double sigma_;
+    double yield_;
+    Averaging averaging_;
+    InterestRateHandle curve;
+    double dT;
+    double dS;
+    double dA;
+    std::vector<size_t> fixing_levels_;
+    size_t lanes_;
+    bool flat_;
+    std::vector<double> grid;
+
+    void setup();
+    void solve();
+    double payoff(double S, double A) const;
+    void set_boundary(double* u, size_t n, size_t done) const;
+    void step(const double* u, double* y, size_t n) const;
+    void fix(double* u, double m) const;
+    double interpolate(double S, double A, int order) const;
+
+public:
+    /**
+     * @brief Number of adjacent average lines solved together by one task.
+     */
+    static const size_t TILE = 32;
+
+    /**
+     * @brief Constructs and prices an Asian option.
+     * @param contract_type Type of contract (1 for Call, -1 for Put).
+     * @param strike_type Fixed or floating strike.
+     * @param T Maturity of the option.
+     * @param K Strike price; ignored for a floating strike.
+     * @param T0 Initial time.
+     * @param time_mesh Number of time steps.
+     * @param spot_mesh Number of spot steps.
+     * @param average_mesh Number of average steps.
+     * @param S0 Initial spot price.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param volatility Volatility of the underlying.
+     * @param averaging Fixing schedule.
+     * @param yield Continuous dividend yield.
+     * @param S_max Upper bound of the spot and average grids; 0 uses \( 5 S_0 \).
+     */
+    AsianOption(int contract_type, AsianStrike strike_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh,
+        unsigned int average_mesh, double S0, InterestRateHandle rate_curve, double volatility, const Averaging& averaging, double yield = 0, double S_max = 0);
+
+    /**
+     * @brief Returns the option value at any point of the grid domain.
+     * @param S Spot price.
+     * @param A Average of the past fixings; ignored when none has been observed.
+     * @return Interpolated value at \( T_0 \).
+     */
+    double value(double S, double A) const;
+
+    /**
+     * @brief Returns the price of the option.
+     * @return Value at \( S_0 \) and the past average, at \( T_0 \).
+     */
+    double price() const;
+
+    /**
+     * @brief Returns the delta of the option.
+     * @return \( \partial V / \partial S \) at \( S_0 \) and the past average.
+     */
+    double delta() const;
+
+    /**
+     * @brief Returns the gamma of the option.
+     * @return \( \partial^2 V / \partial S^2 \) at \( S_0 \) and the past average.
+     */
+    double gamma() const;
+};
\ No newline at end of file
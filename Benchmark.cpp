@@ -0,0 +1,61 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Contains the timing helpers of the numerical kernels.
+ */
+
+#include "Benchmark.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/**
+ * @brief Times the Thomas and partitioned tridiagonal solvers on a Crank-Nicolson system.
+ *
+ * Both solvers are run once before timing, so that the arena blocks and the pool workers are warm.
+ *
+ * @param n Number of unknowns.
+ * @param repeats Number of solves timed for each algorithm.
+ * @return Mean timings and agreement of the two solvers.
+ */
+SolverTiming benchmark_tridiag(size_t n, size_t repeats) {
+    ArenaScope scope;
+    const double sigma = 0.2, r = 0.03, dT = 1e-3;
+    ScratchVector a(n - 1), b(n), c(n - 1), rhs(n);
+    for (size_t jj = 1; jj <= n; jj++) {
+        double j = static_cast<double>(jj);
+        b[jj - 1] = 1.0 + (dT / 2) * (sigma * sigma * j * j + r);
+        if (jj < n) c[jj - 1] = -(dT / 4) * (sigma * sigma * j * j + r * j);
+        if (jj > 1) a[jj - 2] = -(dT / 4) * (sigma * sigma * j * j - r * j);
+        rhs[jj - 1] = std::sin(0.01 * j);
+    }
+    Tridiag C(std::move(a), std::move(b), std::move(c));
+
+    SolverTiming res;
+    res.n = n;
+    res.threads = ThreadPool::global().size();
+
+    ScratchVector x1 = C.solve(rhs, TridiagSolver::Thomas);
+    ScratchVector x2 = C.solve(rhs, TridiagSolver::Partitioned);
+    res.max_diff = 0;
+    for (size_t ii = 0; ii < n; ii++) {
+        res.max_diff = std::max(res.max_diff, std::fabs(x1[ii] - x2[ii]));
+    }
+
+    TridiagSolver solvers[2] = { TridiagSolver::Thomas, TridiagSolver::Partitioned };
+    double* times[2] = { &res.thomas_ms, &res.partitioned_ms };
+    volatile double sink = 0;
+    for (size_t ss = 0; ss < 2; ss++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t kk = 0; kk < repeats; kk++) {
+            ArenaScope solve;
+            ScratchVector x = C.solve(rhs, solvers[ss]);
+            sink += x[n / 2];
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        *times[ss] = elapsed.count() / repeats;
+    }
+
+    return res;
+}
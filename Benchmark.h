@@ -0,0 +1,33 @@
+/**
+ * @file Benchmark.h
+ * @brief Timing helpers comparing the alternative numerical kernels of the library.
+ */
+
+#pragma once
+
+#include "Tridiag.h"
+
+#include <cstddef>
+
+/**
+ * @brief Timings of the tridiagonal solvers on one system size.
+ */
+struct SolverTiming {
+    size_t n;              ///< Number of unknowns.
+    size_t threads;        ///< Threads of the global pool.
+    double thomas_ms;      ///< Mean time of a Thomas solve, in milliseconds.
+    double partitioned_ms; ///< Mean time of a partitioned solve, in milliseconds.
+    double max_diff;       ///< Largest absolute difference between the two solutions.
+};
+
+/**
+ * @brief Times the Thomas and partitioned tridiagonal solvers on a Crank-Nicolson system.
+ *
+ * The matrix is the implicit matrix \( C \) of the Black-Scholes scheme with \( \sigma = 0.2 \),
+ * \( r = 0.03 \) and \( \Delta t = 10^{-3} \) on `n` interior nodes; the right-hand side is fixed.
+ *
+ * @param n Number of unknowns.
+ * @param repeats Number of solves timed for each algorithm.
+ * @return Mean timings and agreement of the two solvers.
+ */
+SolverTiming benchmark_tridiag(size_t n, size_t repeats = 20);
@@ -0,0 +1,235 @@
+/**
+ * @file Dupire.cpp
+ * @brief Contains the methods of the forward Dupire solver.
+ */
+
+#include "Dupire.h"
+#include "Arena.h"
+#include "Tridiag.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs the solver with a flat volatility and runs the forward sweep.
+ * @param S0 Spot price.
+ * @param T Last maturity of the grid.
+ * @param time_mesh Number of maturity steps.
+ * @param strike_mesh Number of strike steps.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param volatility Volatility of the underlying asset.
+ * @param dividend_yield Continuous dividend yield curve; nullptr for none.
+ * @param repo Repo rate curve; nullptr for none.
+ * @param K_max Upper bound of the strike grid; 0 uses \( 5 S_0 \).
+ */
+Dupire::Dupire(double S0, double T, unsigned int time_mesh, unsigned int strike_mesh, InterestRateHandle rate_curve, double volatility,
+    InterestRateHandle dividend_yield, InterestRateHandle repo, double K_max)
+    : S0_(S0), T_(T), time_mesh_(time_mesh), strike_mesh_(strike_mesh), K_max_(K_max > 0 ? K_max : 5 * S0), volatility_(volatility),
+    curve(std::move(rate_curve)), dividend_yield_(std::move(dividend_yield)), repo_(std::move(repo)) {
+    setup();
+}
+
+/**
+ * @brief Constructs the solver with a local volatility surface and runs the forward sweep.
+ * @param S0 Spot price.
+ * @param T Last maturity of the grid.
+ * @param time_mesh Number of maturity steps.
+ * @param strike_mesh Number of strike steps.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param local_vol Local volatility surface \( \sigma(K, T) \).
+ * @param dividend_yield Continuous dividend yield curve; nullptr for none.
+ * @param repo Repo rate curve; nullptr for none.
+ * @param K_max Upper bound of the strike grid; 0 uses \( 5 S_0 \).
+ */
+Dupire::Dupire(double S0, double T, unsigned int time_mesh, unsigned int strike_mesh, InterestRateHandle rate_curve, LocalVolHandle local_vol,
+    InterestRateHandle dividend_yield, InterestRateHandle repo, double K_max)
+    : S0_(S0), T_(T), time_mesh_(time_mesh), strike_mesh_(strike_mesh), K_max_(K_max > 0 ? K_max : 5 * S0),
+    volatility_(local_vol ? (*local_vol)(S0, 0) : 0), local_vol_(std::move(local_vol)),
+    curve(std::move(rate_curve)), dividend_yield_(std::move(dividend_yield)), repo_(std::move(repo)) {
+    if (!local_vol_) throw InvalidLocalVol(0);
+    setup();
+}
+
+/**
+ * @brief Validates the parameters, sets up the mesh and runs the forward sweep.
+ */
+void Dupire::setup() {
+    if (!(T_ > 0)) throw InvalidMaturity();
+    if (time_mesh_ <= 0) throw InvalidTimeMesh(time_mesh_);
+    if (strike_mesh_ < 3) throw InvalidSpotMesh(strike_mesh_);
+    if (S0_ <= 0) throw InvalidSpot(S0_);
+    if (volatility_ <= 0) throw InvalidVolatility(volatility_);
+    if (K_max_ <= S0_) throw InvalidDomain(K_max_);
+
+    dT = T_ / time_mesh_;
+    dK = K_max_ / strike_mesh_;
+    if (local_vol_) sigma2_ = local_vol_->variance_table(0, dK, strike_mesh_ + 1, dT, time_mesh_ + 1);
+    fill_curves();
+    solve();
+}
+
+/**
+ * @brief Tabulates the term structures on the maturity levels.
+ *
+ * For each level \( i \), at \( T_i = i \, \Delta T \), stores the short rate \( r \), the yield
+ * \( q \) (dividend yield plus repo rate) and the carry factor \( e^{-\int q} \) of the boundary
+ * \( K = 0 \).
+ */
+void Dupire::fill_curves() {
+    rates_.resize(time_mesh_ + 1);
+    yields_.resize(time_mesh_ + 1);
+    carries_.resize(time_mesh_ + 1);
+    for (size_t ii = 0; ii <= time_mesh_; ii++) {
+        double t = dT * ii;
+        double q = 0;
+        if (dividend_yield_) q += (*dividend_yield_)(t);
+        if (repo_) q += (*repo_)(t);
+        rates_[ii] = (*curve)(t);
+        yields_[ii] = q;
+        carries_[ii] = carry(t);
+    }
+}
+
+/**
+ * @brief Returns the carry factor of the spot to a maturity.
+ *
+ * `InterestRate::integral` integrates a curve from its argument to the last pillar, so the
+ * integral over \( [0, T] \) is the difference of two calls.
+ *
+ * @param T Maturity.
+ * @return \( e^{-\int_0^T q} \).
+ */
+double Dupire::carry(double T) const {
+    double Q = 0;
+    if (dividend_yield_) Q += dividend_yield_->integral(0) - dividend_yield_->integral(T);
+    if (repo_) Q += repo_->integral(0) - repo_->integral(T);
+    return std::exp(-Q);
+}
+
+/**
+ * @brief Returns the discount factor to a maturity.
+ * @param T Maturity.
+ * @return \( e^{-\int_0^T r} \).
+ */
+double Dupire::discount(double T) const {
+    return std::exp(-(curve->integral(0) - curve->integral(T)));
+}
+
+/**
+ * @brief Runs the forward sweep from the initial payoff to the last maturity.
+ *
+ * At node \( j \), \( K = j \Delta K \), the operator has the weights \( a + b \), \( -2a - q \) and
+ * \( a - b \) on the nodes \( j - 1, j, j + 1 \), with \( a = \tfrac{1}{2} \sigma^2 j^2 \) and
+ * \( b = \tfrac{1}{2} (r - q) j \). A step from level \( i \) to \( i + 1 \) solves
+ * \[
+ * (I - \tfrac{\Delta T}{2} L_{i+1}) C^{i+1} = (I + \tfrac{\Delta T}{2} L_i) C^i + k,
+ * \]
+ * \( k \) carrying the boundary values at \( K = 0 \) of both levels. The coefficients of a level
+ * are formed once, for \( C \) at one step and for \( D \) at the next.
+ */
+void Dupire::solve() {
+    ArenaScope sweep;
+    size_t row = strike_mesh_ + 1;
+    size_t n = strike_mesh_ - 1;
+    double w = dT / 2;
+    grid.assign((time_mesh_ + 1) * row, 0.0);
+    for (size_t jj = 0; jj < row; jj++) {
+        grid[jj] = std::max(S0_ - jj * dK, 0.0);
+    }
+
+    // Weights of the nodes j - 1, j and j + 1 at the interior nodes of a level.
+    auto weights = [&](size_t i, ScratchVector& lo, ScratchVector& mid, ScratchVector& up) {
+        double r = rates_[i], q = yields_[i];
+        for (size_t jj = 1; jj < strike_mesh_; jj++) {
+            double a = 0.5 * sigma2(jj, i) * jj * jj, b = 0.5 * (r - q) * jj;
+            lo[jj - 1] = a + b;
+            mid[jj - 1] = -2 * a - q;
+            up[jj - 1] = a - b;
+        }
+    };
+
+    ScratchVector lo(n), mid(n), up(n), lo_next(n), mid_next(n), up_next(n);
+    Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    Tridiag D(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    weights(0, lo, mid, up);
+
+    for (size_t ii = 0; ii < time_mesh_; ii++) {
+        weights(ii + 1, lo_next, mid_next, up_next);
+        for (size_t kk = 0; kk < n; kk++) {
+            if (kk > 0) {
+                D.subdiag()[kk - 1] = w * lo[kk];
+                C.subdiag()[kk - 1] = -w * lo_next[kk];
+            }
+            D.diag()[kk] = 1 + w * mid[kk];
+            C.diag()[kk] = 1 - w * mid_next[kk];
+            if (kk + 1 < n) {
+                D.superdiag()[kk] = w * up[kk];
+                C.superdiag()[kk] = -w * up_next[kk];
+            }
+        }
+
+        const double* prev = grid.data() + ii * row;
+        double* curr = grid.data() + (ii + 1) * row;
+        curr[0] = S0_ * carries_[ii + 1];
+        curr[strike_mesh_] = 0;
+        double k1 = w * lo[0] * prev[0] + w * lo_next[0] * curr[0];
+        C.solve_product(D, prev + 1, std::make_pair(k1, 0.0), curr + 1);
+
+        lo.swap(lo_next);
+        mid.swap(mid_next);
+        up.swap(up_next);
+    }
+}
+
+/**
+ * @brief Returns the price of a European call.
+ *
+ * Quadratic Lagrange interpolation on the three strike nodes around \( K \) of the two levels that
+ * bracket \( T \), then linear interpolation between the levels.
+ *
+ * @param K Strike, between 0 and \( K_{max} \).
+ * @param T Maturity, between 0 and the last maturity of the grid.
+ * @return Interpolated call price.
+ */
+double Dupire::call(double K, double T) const {
+    if (!(K >= 0 && K <= K_max_)) throw InvalidStrike(K);
+    if (!(T >= 0 && T <= T_)) throw InvalidMaturity();
+    double x = K / dK;
+    size_t m = static_cast<size_t>(std::min<double>(std::max<double>(std::round(x), 1), strike_mesh_ - 1));
+    double t = x - m;
+    double wk[3] = { t * (t - 1) / 2, 1 - t * t, t * (t + 1) / 2 };
+
+    double p = T / dT;
+    size_t i = std::min(static_cast<size_t>(p), static_cast<size_t>(time_mesh_ - 1));
+    double s = p - i;
+    const double* a = level(i) + m - 1;
+    const double* b = level(i + 1) + m - 1;
+    double va = wk[0] * a[0] + wk[1] * a[1] + wk[2] * a[2];
+    double vb = wk[0] * b[0] + wk[1] * b[1] + wk[2] * b[2];
+    return (1 - s) * va + s * vb;
+}
+
+/**
+ * @brief Returns the price of a European put, from the put-call parity.
+ * @param K Strike, between 0 and \( K_{max} \).
+ * @param T Maturity, between 0 and the last maturity of the grid.
+ * @return \( C(K, T) - S_0 e^{-\int_0^T q} + K e^{-\int_0^T r} \).
+ */
+double Dupire::put(double K, double T) const {
+    return call(K, T) - S0_ * carry(T) + K * discount(T);
+}
+
+/**
+ * @brief Returns the prices of European calls for several strikes of the same maturity.
+ * @param strikes Strikes, between 0 and \( K_{max} \).
+ * @param T Maturity, between 0 and the last maturity of the grid.
+ * @return Call price for each strike, in the same order.
+ */
+std::vector<double> Dupire::calls(const std::vector<double>& strikes, double T) const {
+    std::vector<double> prices;
+    prices.reserve(strikes.size());
+    for (double K : strikes) {
+        prices.push_back(call(K, T));
+    }
+    return prices;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+/**
+ * @file Dupire.h
+ * @brief Forward Crank-Nicolson solver of the Dupire equation, pricing European calls for all strikes and maturities at once.
+ */
+
+#pragma once
+
+#include "InterestRate.h"
+#include "LocalVol.h"
+#include "OptionExceptions.h"
+
+#include <vector>
+
+/**
+ * @class Dupire
+ * @brief Prices European calls and puts on a whole strike and maturity grid with one forward sweep.
+ *
+ * Under a local volatility \( \sigma(K, T) \) the call prices \( C(K, T) \) of a fixed spot \( S_0 \)
+ * solve the forward equation
+ * \[
+ * \frac{\partial C}{\partial T} = \frac{1}{2} \sigma^2(K, T) K^2 \frac{\partial^2 C}{\partial K^2} - (r - q) K \frac{\partial C}{\partial K} - q C,
+ * \qquad C(K, 0) = \max(S_0 - K, 0),
+ * \]
+ * with \( q \) the dividend yield plus the repo rate. It is discretised on a uniform strike grid
+ * \( [0, K_{max}] \) and advanced in maturity with Crank-Nicolson steps, each a fused product and
+ * Thomas elimination of `Tridiag::solve_product`; the boundary values are \( S_0 e^{-\int q} \) at
+ * \( K = 0 \) and 0 at \( K_{max} \).
+ *
+ * The term structures are tabulated once on the maturity levels, as in `Option`, and a local
+ * volatility surface is tabulated with `LocalVol::variance_table` on the strike nodes. Every level
+ * of the sweep is kept: one solve gives the calls at every strike of every intermediate maturity,
+ * read back with quadratic interpolation in \( K \) and linear interpolation in \( T \); puts follow
+ * from the put-call parity.
+ */
+class Dupire {
+    double S0_;
+    double T_;
+    unsigned int time_mesh_;
+    unsigned int strike_mesh_;
+    double K_max_;
+    double volatility_;
+    LocalVolHandle local_vol_;
+    InterestRateHandle curve;
+    InterestRateHandle dividend_yield_;
+    InterestRateHandle repo_;
+    double dT;
+    double dK;
+    std::vector<double> rates_;
+    std::vector<double> yields_;
+    std::vector<double> carries_;
+    std::vector<double> sigma2_;
+    std::vector<double> grid;
+
+    void setup();
+    void fill_curves();
+    void solve();
+    double sigma2(size_t j, size_t i) const { return sigma2_.empty() ? volatility_ * volatility_ : sigma2_[i * (strike_mesh_ + 1) + j]; }
+    const double* level(size_t i) const { return grid.data() + i * (strike_mesh_ + 1); }
+    double carry(double T) const;
+    double discount(double T) const;
+
+public:
+    /**
+     * @brief Constructs the solver with a flat volatility and runs the forward sweep.
+     * @param S0 Spot price.
+     * @param T Last maturity of the grid.
+     * @param time_mesh Number of maturity steps.
+     * @param strike_mesh Number of strike steps.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param volatility Volatility of the underlying asset.
+     * @param dividend_yield Continuous dividend yield curve; nullptr for none.
+     * @param repo Repo rate curve; nullptr for none.
+     * @param K_max Upper bound of the strike grid; 0 uses \( 5 S_0 \).
+     */
+    Dupire(double S0, double T, unsigned int time_mesh, unsigned int strike_mesh, InterestRateHandle rate_curve, double volatility,
+        InterestRateHandle dividend_yield = nullptr, InterestRateHandle repo = nullptr, double K_max = 0);
+
+    /**
+     * @brief Constructs the solver with a local volatility surface and runs the forward sweep.
+     * @param S0 Spot price.
+     * @param T Last maturity of the grid.
+     * @param time_mesh Number of maturity steps.
+     * @param strike_mesh Number of strike steps.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param local_vol Local volatility surface \( \sigma(K, T) \).
+     * @param dividend_yield Continuous dividend yield curve; nullptr for none.
+     * @param repo Repo rate curve; nullptr for none.
+     * @param K_max Upper bound of the strike grid; 0 uses \( 5 S_0 \).
+     */
+    Dupire(double S0, double T, unsigned int time_mesh, unsigned int strike_mesh, InterestRateHandle rate_curve, LocalVolHandle local_vol,
+        InterestRateHandle dividend_yield = nullptr, InterestRateHandle repo = nullptr, double K_max = 0);
+
+    /**
+     * @brief Returns the price of a European call.
+     * @param K Strike, between 0 and \( K_{max} \).
+     * @param T Maturity, between 0 and the last maturity of the grid.
+     * @return Interpolated call price.
+     */
+    double call(double K, double T) const;
+
+    /**
+     * @brief Returns the price of a European put, from the put-call parity.
+     * @param K Strike, between 0 and \( K_{max} \).
+     * @param T Maturity, between 0 and the last maturity of the grid.
+     * @return \( C(K, T) - S_0 e^{-\int_0^T q} + K e^{-\int_0^T r} \).
+     */
+    double put(double K, double T) const;
+
+    /**
+     * @brief Returns the prices of European calls for several strikes of the same maturity.
+     * @param strikes Strikes, between 0 and \( K_{max} \).
+     * @param T Maturity, between 0 and the last maturity of the grid.
+     * @return Call price for each strike, in the same order.
+     */
+    std::vector<double> calls(const std::vector<double>& strikes, double T) const;
+};
\ No newline at end of file
@@ -0,0 +1,422 @@
+/**
+ * @file Heston.cpp
+ * @brief Contains the methods of the Heston ADI pricer.
+ */
+
+#include "Heston.h"
+#include "Arena.h"
+#include "ThreadPool.h"
+#include "Tridiag.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Weight of the implicit stages of the Hundsdorfer-Verwer scheme, \( \tfrac{1}{2} + \tfrac{\sqrt{3}}{6} \).
+     */
+    const double HV_THETA = 0.5 + std::sqrt(3.0) / 6;
+
+    /**
+     * @brief Minimum number of grid lines per task of the parallel loops.
+     */
+    const size_t LINE_GRAIN = 8;
+
+    /**
+     * @brief Quadratic Lagrange weights on the nodes \( m - 1, m, m + 1 \), or their derivatives.
+     * @param t Position relative to node \( m \), in steps.
+     * @param order Order of the derivative (0, 1 or 2), per step.
+     * @param w Output weights.
+     */
+    void lagrange(double t, int order, double* w) {
+        if (order == 0) {
+            w[0] = t * (t - 1) / 2;
+            w[1] = 1 - t * t;
+            w[2] = t * (t + 1) / 2;
+        }
+        else if (order == 1) {
+            w[0] = t - 0.5;
+            w[1] = -2 * t;
+            w[2] = t + 0.5;
+        }
+        else {
+            w[0] = 1;
+            w[1] = -2;
+            w[2] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Constructs and prices an option under the Heston model.
+ * @param contract_type Type of option: 1 for Call, -1 for Put.
+ * @param exercise_type Exercise type: 1 for European, 0 for American.
+ * @param T Maturity time.
+ * @param K Strike price.
+ * @param T0 Start time.
+ * @param time_mesh Number of time steps.
+ * @param spot_mesh Number of spot steps.
+ * @param var_mesh Number of variance steps.
+ * @param S0 Current spot price.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param params Parameters of the variance process.
+ * @param S_max Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+ * @param v_max Upper bound of the variance grid; 0 uses \( \max(1, 5 \max(v_0, \theta)) \).
+ */
+Heston::Heston(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, unsigned int var_mesh,
+    double S0, InterestRateHandle rate_curve, const HestonParams& params, double S_max, double v_max)
+    : contract_type_(contract_type), exercise_type_(exercise_type), T_(T), K_(K), T0_(T0), S0_(S0), S_max_(S_max > 0 ? S_max : 5 * S0),
+    v_max_(v_max > 0 ? v_max : std::max(1.0, 5 * std::max(params.v0, params.theta))), params_(params),
+    time_mesh_(time_mesh), spot_mesh_(spot_mesh), var_mesh_(var_mesh), curve(std::move(rate_curve)) {
+    setup();
+}
+
+/**
+ * @brief Validates the parameters, sets up the mesh and prices the option.
+ */
+void Heston::setup() {
+    if (contract_type_ != 1 && contract_type_ != -1) throw InvalidContractType(contract_type_);
+    if (exercise_type_ != 1 && exercise_type_ != 0) throw InvalidExerciseType(exercise_type_);
+    if (T_ <= T0_ || T_ < 0) throw InvalidMaturity();
+    if (K_ <= 0) throw InvalidStrike(K_);
+    if (time_mesh_ <= 0) throw InvalidTimeMesh(time_mesh_);
+    if (spot_mesh_ < 3) throw InvalidSpotMesh(spot_mesh_);
+    if (S0_ <= 0) throw InvalidSpot(S0_);
+    if (S_max_ <= S0_) throw InvalidDomain(S_max_);
+    if (!(params_.v0 >= 0)) throw InvalidHeston(params_.v0);
+    if (!(params_.kappa >= 0)) throw InvalidHeston(params_.kappa);
+    if (!(params_.theta >= 0)) throw InvalidHeston(params_.theta);
+    if (!(params_.xi > 0)) throw InvalidHeston(params_.xi);
+    if (!(std::fabs(params_.rho) <= 1)) throw InvalidHeston(params_.rho);
+    if (var_mesh_ < 3) throw InvalidHeston(var_mesh_);
+    if (v_max_ <= params_.v0) throw InvalidHeston(v_max_);
+
+    dT = (T_ - T0_) / time_mesh_;
+    dS = S_max_ / spot_mesh_;
+    dV = v_max_ / var_mesh_;
+    solve();
+}
+
+/**
+ * @brief Returns the short rate at a time to maturity.
+ * @param tau Time to maturity.
+ * @return Rate of the curve at \( T - T_0 - \tau \) on the curve clock.
+ */
+double Heston::rate(double tau) const {
+    return (*curve)(T_ - T0_ - tau);
+}
+
+/**
+ * @brief Writes the Dirichlet values of the boundaries \( S = 0 \), \( S = S_{max} \) and \( v = v_{max} \).
+ * @param u Grid values, variance line by variance line.
+ * @param tau Time to maturity.
+ */
+void Heston::set_boundaries(double* u, double tau) const {
+    double disc = exercise_type_ ? std::exp(-(curve->integral(T_ - T0_ - tau) - curve->integral(T_ - T0_))) : 1.0;
+    double* top = u + index(0, var_mesh_);
+    for (size_t ii = 0; ii <= spot_mesh_; ii++) {
+        top[ii] = contract_type_ == 1 ? ii * dS : K_ * disc;
+    }
+    for (size_t jj = 0; jj <= var_mesh_; jj++) {
+        u[index(0, jj)] = contract_type_ == 1 ? 0.0 : K_ * disc;
+        u[index(spot_mesh_, jj)] = contract_type_ == 1 ? S_max_ - K_ * disc : 0.0;
+    }
+}
+
+/**
+ * @brief Applies the mixed-derivative operator \( A_0 \) to the interior nodes.
+ *
+ * \( \rho \xi S v \, u_{Sv} \) with the four-point central difference; it vanishes on \( v = 0 \).
+ *
+ * @param u Grid values.
+ * @param out Result at the interior nodes; the other nodes are left untouched.
+ */
+void Heston::apply_mixed(const double* u, double* out) const {
+    size_t row = spot_mesh_ + 1;
+    double c = params_.rho * params_.xi / 4;
+    ThreadPool::global().parallel_for(0, var_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            const double* mid = u + index(0, jj);
+            double* res = out + index(0, jj);
+            if (jj == 0) {
+                std::fill(res + 1, res + spot_mesh_, 0.0);
+                continue;
+            }
+            for (size_t ii = 1; ii < spot_mesh_; ii++) {
+                res[ii] = c * ii * jj * (mid[ii + 1 + row] - mid[ii + 1 - row] - mid[ii - 1 + row] + mid[ii - 1 - row]);
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Applies the spot operator \( A_1 \) to the interior nodes.
+ *
+ * \( \tfrac{1}{2} v S^2 u_{SS} + r S u_S - \tfrac{1}{2} r u \), with \( S = i \Delta S \) and \( v = j \Delta v \).
+ *
+ * @param u Grid values.
+ * @param r Short rate.
+ * @param out Result at the interior nodes.
+ */
+void Heston::apply_spot(const double* u, double r, double* out) const {
+    ThreadPool::global().parallel_for(0, var_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            const double* x = u + index(0, jj);
+            double* res = out + index(0, jj);
+            double v = jj * dV;
+            for (size_t ii = 1; ii < spot_mesh_; ii++) {
+                double a = 0.5 * v * ii * ii, b = 0.5 * r * ii;
+                res[ii] = (a - b) * x[ii - 1] + (-2 * a - r / 2) * x[ii] + (a + b) * x[ii + 1];
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Applies the variance operator \( A_2 \) to the interior nodes.
+ *
+ * \( \tfrac{1}{2} \xi^2 v u_{vv} + \kappa (\theta - v) u_v - \tfrac{1}{2} r u \); on \( v = 0 \) only the
+ * drift \( \kappa \theta u_v \), with a forward difference, and the discount term remain.
+ *
+ * @param u Grid values.
+ * @param r Short rate.
+ * @param out Result at the interior nodes.
+ */
+void Heston::apply_var(const double* u, double r, double* out) const {
+    size_t row = spot_mesh_ + 1;
+    double up0 = params_.kappa * params_.theta / dV;
+    ThreadPool::global().parallel_for(0, var_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            const double* x = u + index(0, jj);
+            double* res = out + index(0, jj);
+            if (jj == 0) {
+                for (size_t ii = 1; ii < spot_mesh_; ii++) {
+                    res[ii] = up0 * (x[ii + row] - x[ii]) - r / 2 * x[ii];
+                }
+                continue;
+            }
+            double d = 0.5 * params_.xi * params_.xi * jj / dV;
+            double c = params_.kappa * (params_.theta - jj * dV) / (2 * dV);
+            for (size_t ii = 1; ii < spot_mesh_; ii++) {
+                res[ii] = (d - c) * x[ii - row] + (-2 * d - r / 2) * x[ii] + (d + c) * x[ii + row];
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Solves \( (I - w A_1) y = b \) on every variance line below \( v_{max} \).
+ * @param y Right-hand side at the interior nodes and new boundary values; overwritten with the solution.
+ * @param r Short rate.
+ * @param w Weight of the implicit operator, \( \theta \Delta \tau \).
+ */
+void Heston::solve_spot(double* y, double r, double w) const {
+    size_t n = spot_mesh_ - 1;
+    ThreadPool::global().parallel_for(0, var_mesh_, [&](size_t lo, size_t hi) {
+        ArenaScope lines;
+        Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+        ScratchVector b(n);
+        for (size_t jj = lo; jj < hi; jj++) {
+            double* x = y + index(0, jj);
+            double v = jj * dV;
+            for (size_t ii = 1; ii < spot_mesh_; ii++) {
+                double a = 0.5 * v * ii * ii, c = 0.5 * r * ii;
+                if (ii > 1) C.subdiag()[ii - 2] = -w * (a - c);
+                C.diag()[ii - 1] = 1 + w * (2 * a + r / 2);
+                if (ii < spot_mesh_ - 1) C.superdiag()[ii - 1] = -w * (a + c);
+                b[ii - 1] = x[ii];
+                if (ii == 1) b[0] += w * (a - c) * x[0];
+                if (ii == spot_mesh_ - 1) b[n - 1] += w * (a + c) * x[spot_mesh_];
+            }
+            b = C.solve(std::move(b), TridiagSolver::Thomas);
+            std::copy(b.begin(), b.end(), x + 1);
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Solves \( (I - w A_2) y = b \) on every interior spot line.
+ *
+ * The coefficients of \( A_2 \) do not depend on the spot, so all the spot lines share one matrix:
+ * they are solved as the lanes of `Tridiag::solve_lanes`, which walks the grid variance line by
+ * variance line instead of gathering each spot line with a stride.
+ *
+ * @param y Right-hand side at the interior nodes and new boundary values; overwritten with the solution.
+ * @param r Short rate.
+ * @param w Weight of the implicit operator, \( \theta \Delta \tau \).
+ */
+void Heston::solve_var(double* y, double r, double w) const {
+    ArenaScope lines;
+    size_t n = var_mesh_;
+    size_t row = spot_mesh_ + 1;
+    double up0 = params_.kappa * params_.theta / dV;
+    Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    C.diag()[0] = 1 + w * (up0 + r / 2);
+    C.superdiag()[0] = -w * up0;
+    for (size_t jj = 1; jj < n; jj++) {
+        double d = 0.5 * params_.xi * params_.xi * jj / dV;
+        double c = params_.kappa * (params_.theta - jj * dV) / (2 * dV);
+        C.subdiag()[jj - 1] = -w * (d - c);
+        C.diag()[jj] = 1 + w * (2 * d + r / 2);
+        if (jj < n - 1) C.superdiag()[jj] = -w * (d + c);
+    }
+    double d = 0.5 * params_.xi * params_.xi * (n - 1) / dV;
+    double c = params_.kappa * (params_.theta - (n - 1) * dV) / (2 * dV);
+
+    ThreadPool::global().parallel_for(1, spot_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t ii = lo; ii < hi; ii++) {
+            y[(n - 1) * row + ii] += w * (d + c) * y[n * row + ii];
+        }
+        C.solve_lanes(y + lo, hi - lo, row);
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Runs the backward sweep from the payoff to the initial time.
+ *
+ * One Hundsdorfer-Verwer step from \( \tau_n \) to \( \tau_{n+1} \), with \( F_k = A_k u \):
+ * \[
+ * \begin{aligned}
+ * Y_0 &= u + \Delta\tau \, F(\tau_n, u), \\
+ * Y_k &= Y_{k-1} + \theta \Delta\tau \left( F_k(\tau_{n+1}, Y_k) - F_k(\tau_n, u) \right), \quad k = 1, 2, \\
+ * \tilde{Y}_0 &= Y_0 + \tfrac{1}{2} \Delta\tau \left( F(\tau_{n+1}, Y_2) - F(\tau_n, u) \right), \\
+ * \tilde{Y}_k &= \tilde{Y}_{k-1} + \theta \Delta\tau \left( F_k(\tau_{n+1}, \tilde{Y}_k) - F_k(\tau_{n+1}, Y_2) \right), \quad k = 1, 2,
+ * \end{aligned}
+ * \]
+ * and \( u^{n+1} = \tilde{Y}_2 \). The values before the last step are kept for `theta`.
+ */
+void Heston::solve() {
+    size_t size = (spot_mesh_ + 1) * static_cast<size_t>(var_mesh_ + 1);
+    std::vector<double> u(size), y0(size), y(size), fs(size), f1(size), f2(size), tmp(size);
+    std::vector<double> payoff(size);
+    size_t row = spot_mesh_ + 1;
+    for (size_t jj = 0; jj <= var_mesh_; jj++) {
+        for (size_t ii = 0; ii <= spot_mesh_; ii++) {
+            payoff[jj * row + ii] = std::max(contract_type_ * (ii * dS - K_), 0.0);
+        }
+    }
+    u = payoff;
+    set_boundaries(u.data(), 0);
+
+    double w = HV_THETA * dT;
+    auto interior = [&](auto body) {
+        ThreadPool::global().parallel_for(0, var_mesh_, [&](size_t lo, size_t hi) {
+            for (size_t jj = lo; jj < hi; jj++) {
+                for (size_t ii = 1; ii < spot_mesh_; ii++) body(jj * row + ii);
+            }
+        }, LINE_GRAIN);
+    };
+
+    for (size_t nn = 0; nn < time_mesh_; nn++) {
+        if (nn + 1 == time_mesh_) first_ = u;
+        double tau = dT * nn, tau_next = dT * (nn + 1);
+        double r = rate(tau), r_next = rate(tau_next);
+
+        apply_mixed(u.data(), tmp.data());
+        apply_spot(u.data(), r, f1.data());
+        apply_var(u.data(), r, f2.data());
+        interior([&](size_t k) {
+            fs[k] = tmp[k] + f1[k] + f2[k];
+            y0[k] = u[k] + dT * fs[k];
+            y[k] = y0[k] - w * f1[k];
+        });
+        set_boundaries(y.data(), tau_next);
+        solve_spot(y.data(), r_next, w);
+        interior([&](size_t k) { y[k] -= w * f2[k]; });
+        solve_var(y.data(), r_next, w);
+
+        apply_mixed(y.data(), tmp.data());
+        apply_spot(y.data(), r_next, f1.data());
+        apply_var(y.data(), r_next, f2.data());
+        interior([&](size_t k) {
+            y0[k] += 0.5 * dT * (tmp[k] + f1[k] + f2[k] - fs[k]);
+            y0[k] -= w * f1[k];
+        });
+        set_boundaries(y0.data(), tau_next);
+        solve_spot(y0.data(), r_next, w);
+        interior([&](size_t k) { y0[k] -= w * f2[k]; });
+        solve_var(y0.data(), r_next, w);
+
+        u.swap(y0);
+        if (!exercise_type_) {
+            for (size_t k = 0; k < size; k++) u[k] = std::max(u[k], payoff[k]);
+        }
+    }
+    grid = std::move(u);
+}
+
+/**
+ * @brief Interpolates the values of a grid, or their derivatives, with quadratic Lagrange polynomials.
+ * @param values Grid values at one time.
+ * @param S Spot price.
+ * @param v Variance.
+ * @param spot_order Order of the derivative in \( S \) (0, 1 or 2).
+ * @param var_order Order of the derivative in \( v \) (0 or 1).
+ * @return Interpolated value or derivative.
+ */
+double Heston::interpolate(const std::vector<double>& values, double S, double v, int spot_order, int var_order) const {
+    double xs = S / dS, xv = v / dV;
+    size_t ms = static_cast<size_t>(std::min<double>(std::max<double>(std::round(xs), 1), spot_mesh_ - 1));
+    size_t mv = static_cast<size_t>(std::min<double>(std::max<double>(std::round(xv), 1), var_mesh_ - 1));
+    double ws[3], wv[3];
+    lagrange(xs - ms, spot_order, ws);
+    lagrange(xv - mv, var_order, wv);
+
+    double res = 0;
+    for (size_t jj = 0; jj < 3; jj++) {
+        for (size_t ii = 0; ii < 3; ii++) {
+            res += wv[jj] * ws[ii] * values[index(ms - 1 + ii, mv - 1 + jj)];
+        }
+    }
+    return res / (std::pow(dS, spot_order) * std::pow(dV, var_order));
+}
+
+/**
+ * @brief Returns the option value at any point of the grid domain.
+ * @param S Spot price.
+ * @param v Variance.
+ * @return Interpolated value at \( T_0 \).
+ */
+double Heston::value(double S, double v) const {
+    return interpolate(grid, S, v, 0, 0);
+}
+
+/**
+ * @brief Returns the price of the option.
+ * @return Value at \( (S_0, v_0) \) and \( T_0 \).
+ */
+double Heston::price() const {
+    return value(S0_, params_.v0);
+}
+
+/**
+ * @brief Returns the delta of the option.
+ * @return \( \partial V / \partial S \) at \( (S_0, v_0) \).
+ */
+double Heston::delta() const {
+    return interpolate(grid, S0_, params_.v0, 1, 0);
+}
+
+/**
+ * @brief Returns the gamma of the option.
+ * @return \( \partial^2 V / \partial S^2 \) at \( (S_0, v_0) \).
+ */
+double Heston::gamma() const {
+    return interpolate(grid, S0_, params_.v0, 2, 0);
+}
+
+/**
+ * @brief Returns the vega of the option with respect to the initial volatility.
+ * @return \( 2 \sqrt{v_0} \, \partial V / \partial v \) at \( (S_0, v_0) \).
+ */
+double Heston::vega() const {
+    return 2 * std::sqrt(params_.v0) * interpolate(grid, S0_, params_.v0, 0, 1);
+}
+
+/**
+ * @brief Returns the theta of the option.
+ * @return \( (V(T_0 + \Delta T) - V(T_0)) / \Delta T \) at \( (S_0, v_0) \).
+ */
+double Heston::theta() const {
+    return (interpolate(first_, S0_, params_.v0, 0, 0) - price()) / dT;
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+/**
+ * @file ImpliedVol.cpp
+ * @brief Contains the Newton-Brent implied volatility search.
+ */
+
+#include "ImpliedVol.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Standard normal cumulative distribution function.
+     * @param x Argument.
+     * @return \( N(x) \).
+     */
+    double norm_cdf(double x) {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    /**
+     * @brief Black-Scholes price of a European option.
+     * @param type 1 for Call, -1 for Put.
+     * @param S Spot price.
+     * @param K Strike price.
+     * @param tau Time to maturity.
+     * @param r Continuously compounded rate.
+     * @param vol Volatility.
+     * @return Option price.
+     */
+    double black_scholes(int type, double S, double K, double tau, double r, double vol) {
+        double sd = vol * std::sqrt(tau);
+        double d1 = (std::log(S / K) + (r + 0.5 * vol * vol) * tau) / sd;
+        double d2 = d1 - sd;
+        return type * (S * norm_cdf(type * d1) - K * std::exp(-r * tau) * norm_cdf(type * d2));
+    }
+}
+
+/**
+ * @brief Constructs the solver.
+ * @param time_mesh Number of time steps in the grid.
+ * @param spot_mesh Number of spot steps in the grid.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param settings Parameters of the search.
+ * @param psor Settings of the projected SOR solver used for American exercise.
+ */
+ImpliedVol::ImpliedVol(unsigned int time_mesh, unsigned int spot_mesh, InterestRateHandle rate_curve,
+    const ImpliedVolSettings& settings, const PSORSettings& psor)
+    : time_mesh_(time_mesh), spot_mesh_(spot_mesh), curve_(std::move(rate_curve)), psor_(psor), settings_(settings) {}
+
+/**
+ * @brief Computes the Black-Scholes implied volatility of a quote, used as the initial guess.
+ *
+ * The rate is the average of the curve over the life of the option, from a trapezoidal rule on
+ * its pillars; the volatility is found by bisection on the closed-form price, which is monotone.
+ * American quotes are treated as European, which overestimates their volatility by the early
+ * exercise premium. Quotes below the European bounds get the middle of the bracket in log terms.
+ *
+ * @param quote Option quote.
+ * @return Black-Scholes implied volatility, clipped to the bracket.
+ */
+double ImpliedVol::initial_guess(const VolQuote& quote) const {
+    double tau = quote.T - quote.T0;
+    const size_t STEPS = 16;
+    double r = 0;
+    for (size_t ii = 0; ii <= STEPS; ii++) {
+        double weight = (ii == 0 || ii == STEPS) ? 0.5 : 1.0;
+        r += weight * (*curve_)(tau * ii / STEPS) / STEPS;
+    }
+
+    double lo = settings_.vol_lo, hi = settings_.vol_hi;
+    if (tau <= 0) return std::sqrt(lo * hi);
+    double p_lo = black_scholes(quote.contract_type, quote.S0, quote.K, tau, r, lo);
+    double p_hi = black_scholes(quote.contract_type, quote.S0, quote.K, tau, r, hi);
+    if (quote.price <= p_lo) return lo;
+    if (quote.price >= p_hi) return hi;
+
+    for (size_t ii = 0; ii < 60 && hi - lo > 1e-6; ii++) {
+        double mid = 0.5 * (lo + hi);
+        if (black_scholes(quote.contract_type, quote.S0, quote.K, tau, r, mid) < quote.price) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+/**
+ * @brief Computes the implied volatility of one quote.
+ *
+ * The option price is increasing in the volatility, so every priced scenario tightens the bracket
+ * \( [\sigma_{lo}, \sigma_{hi}] \) around the root. Newton steps use the vega from the scenarios
+ * \( \sigma \) and \( \sigma (1 + h) \), priced together. Brent's method (inverse quadratic interpolation with bisection
+ * safeguards) takes over on the current bracket when Newton fails; the bracket ends that have not
+ * been priced yet are priced together in one sweep.
+ *
+ * @param quote Option quote.
+ * @return Implied volatility and convergence information.
+ */
+ImpliedVolResult ImpliedVol::solve(const VolQuote& quote) const {
+    ImpliedVolResult res = { initial_guess(quote), 0, 0, 0, ImpliedVolStatus::MaxIterations };
+    const ImpliedVolSettings& s = settings_;
+
+    Option option(quote.contract_type, quote.exercise_type, quote.T, quote.K, quote.T0, time_mesh_, spot_mesh_, quote.S0, curve_, res.vol, psor_);
+    res.pricings = 1;
+
+    double lo = s.vol_lo, hi = s.vol_hi;
+    double f_lo = 0, f_hi = 0;
+    bool has_lo = false, has_hi = false;
+    double vol = res.vol;
+    double f = option.price() - quote.price;
+    double up = option.vol_ladder({ vol * (1 + s.h) })[0] - quote.price;
+    res.pricings++;
+
+    // Newton iterations, pricing each new iterate together with its vega bump.
+    for (; res.iterations < s.max_newton; res.iterations++) {
+        if (std::fabs(f) <= s.tol) {
+            res.vol = vol;
+            res.error = f;
+            res.status = ImpliedVolStatus::Converged;
+            return res;
+        }
+        if (f < 0) { lo = vol; f_lo = f; has_lo = true; }
+        else { hi = vol; f_hi = f; has_hi = true; }
+
+        double vega = (up - f) / (vol * s.h);
+        double next = vol - f / vega;
+        if (!(vega > 0) || !(next > lo && next < hi)) break;
+
+        std::vector<double> p = option.vol_ladder({ next, next * (1 + s.h) });
+        res.pricings += 2;
+        bool small = std::fabs(next - vol) <= s.vol_tol;
+        vol = next;
+        f = p[0] - quote.price;
+        up = p[1] - quote.price;
+        if (small) {
+            res.iterations++;
+            res.vol = vol;
+            res.error = f;
+            res.status = ImpliedVolStatus::Converged;
+            return res;
+        }
+    }
+    if (std::fabs(f) <= s.tol) {
+        res.vol = vol;
+        res.error = f;
+        res.status = ImpliedVolStatus::Converged;
+        return res;
+    }
+    if (f < 0 && vol > lo) { lo = vol; f_lo = f; has_lo = true; }
+    if (f > 0 && vol < hi) { hi = vol; f_hi = f; has_hi = true; }
+
+    // Brent's method on the bracket.
+    if (!has_lo || !has_hi) {
+        std::vector<double> ends;
+        if (!has_lo) ends.push_back(lo);
+        if (!has_hi) ends.push_back(hi);
+        std::vector<double> p = option.vol_ladder(ends);
+        res.pricings += ends.size();
+        if (!has_lo) f_lo = p[0] - quote.price;
+        if (!has_hi) f_hi = p.back() - quote.price;
+        if (f_lo > 0 || f_hi < 0) {
+            res.vol = f_lo > 0 ? lo : hi;
+            res.error = f_lo > 0 ? f_lo : f_hi;
+            res.status = ImpliedVolStatus::OutOfRange;
+            return res;
+        }
+    }
+
+    double a = lo, fa = f_lo, b = hi, fb = f_hi;
+    double c = a, fc = fa, d = b - a, e = d;
+    for (; res.iterations < s.max_iter; res.iterations++) {
+        if ((fb > 0) == (fc > 0)) { c = a; fc = fa; d = b - a; e = d; }
+        if (std::fabs(fc) < std::fabs(fb)) { a = b; b = c; c = a; fa = fb; fb = fc; fc = fa; }
+
+        double tol1 = 2 * 1e-16 * std::fabs(b) + 0.5 * s.vol_tol;
+        double m = 0.5 * (c - b);
+        if (std::fabs(fb) <= s.tol || std::fabs(m) <= tol1) {
+            res.vol = b;
+            res.error = fb;
+            res.status = ImpliedVolStatus::Converged;
+            return res;
+        }
+
+        if (std::fabs(e) >= tol1 && std::fabs(fa) > std::fabs(fb)) {
+            double p, q, r, t = fb / fa;
+            if (a == c) {
+                p = 2 * m * t;
+                q = 1 - t;
+            }
+            else {
+                q = fa / fc;
+                r = fb / fc;
+                p = t * (2 * m * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (t - 1);
+            }
+            if (p > 0) q = -q;
+            else p = -p;
+            if (2 * p < std::min(3 * m * q - std::fabs(tol1 * q), std::fabs(e * q))) {
+                e = d;
+                d = p / q;
+            }
+            else {
+                d = m;
+                e = m;
+            }
+        }
+        else {
+            d = m;
+            e = m;
+        }
+
+        a = b;
+        fa = fb;
+        b += std::fabs(d) > tol1 ? d : (m > 0 ? tol1 : -tol1);
+        fb = option.vol_ladder({ b })[0] - quote.price;
+        res.pricings++;
+    }
+
+    res.vol = b;
+    res.error = fb;
+    return res;
+}
+
+/**
+ * @brief Computes the implied volatilities of a chain of quotes in parallel.
+ *
+ * Each quote is an independent task on `ThreadPool::global()`; every worker prices in its own
+ * thread-local arena, whose blocks are reused from one quote to the next.
+ *
+ * @param quotes Option quotes.
+ * @return One result per quote, in the same order.
+ */
+std::vector<ImpliedVolResult> ImpliedVol::solve(const std::vector<VolQuote>& quotes) const {
+    std::vector<ImpliedVolResult> res(quotes.size());
+    ThreadPool::global().run(quotes.size(), [&](size_t ii) {
+        res[ii] = solve(quotes[ii]);
+    });
+    return res;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file ImpliedVol.h
+ * @brief Implied volatility solver on top of the Crank-Nicolson pricer.
+ */
+
+#pragma once
+
+#include "InterestRate.h"
+#include "Option.h"
+#include "ProjectedSOR.h"
+
+#include <vector>
+
+/**
+ * @brief Market quote of an option whose volatility is to be implied.
+ */
+struct VolQuote {
+    int contract_type; ///< 1 for Call, -1 for Put.
+    int exercise_type; ///< 1 for European, 0 for American.
+    double T;          ///< Maturity.
+    double K;          ///< Strike price.
+    double T0;         ///< Initial time.
+    double S0;         ///< Spot price.
+    double price;      ///< Quoted option price.
+};
+
+/**
+ * @brief Outcome of an implied volatility search.
+ */
+enum class ImpliedVolStatus {
+    Converged,    ///< The model price matches the quote within the tolerance.
+    OutOfRange,   ///< The quote is outside the prices reachable in the volatility bracket.
+    MaxIterations, ///< The iteration budget was exhausted.
+    NoQuote        ///< No quote was given for this point of a surface.
+};
+
+/**
+ * @brief Implied volatility of one quote.
+ */
+struct ImpliedVolResult {
+    double vol;              ///< Implied volatility (last iterate if not converged).
+    double error;            ///< Model price minus quote at `vol`.
+    size_t iterations;       ///< Newton and Brent iterations performed.
+    size_t pricings;         ///< Number of volatility scenarios priced.
+    ImpliedVolStatus status; ///< Outcome of the search.
+};
+
+/**
+ * @brief Parameters of the implied volatility search.
+ */
+struct ImpliedVolSettings {
+    double tol;        ///< Tolerance on the absolute price error.
+    double vol_tol;    ///< Tolerance on the volatility step.
+    double vol_lo;     ///< Lower end of the volatility bracket.
+    double vol_hi;     ///< Upper end of the volatility bracket.
+    double h;          ///< Relative volatility bump of the finite-difference vega.
+    size_t max_newton; ///< Newton iterations before switching to Brent.
+    size_t max_iter;   ///< Total iteration budget.
+
+    /**
+     * @brief Constructs the search parameters.
+     * @param tol Tolerance on the absolute price error.
+     * @param vol_tol Tolerance on the volatility step.
+     * @param vol_lo Lower end of the volatility bracket.
+     * @param vol_hi Upper end of the volatility bracket.
+     * @param h Relative volatility bump of the vega.
+     * @param max_newton Newton iterations before switching to Brent.
+     * @param max_iter Total iteration budget.
+     */
+    explicit ImpliedVolSettings(double tol = 1e-8, double vol_tol = 1e-10, double vol_lo = 1e-3, double vol_hi = 5.0,
+        double h = 1e-4, size_t max_newton = 8, size_t max_iter = 100)
+        : tol(tol), vol_tol(vol_tol), vol_lo(vol_lo), vol_hi(vol_hi), h(h), max_newton(max_newton), max_iter(max_iter) {}
+};
+
+/**
+ * @class ImpliedVol
+ * @brief Backs out the volatility that reproduces quoted option prices on a given mesh and curve.
+ *
+ * The search starts from the Black-Scholes implied volatility of the quote, computed in closed
+ * form with the average rate of the curve, and runs Newton iterations with a finite-difference
+ * vega. Price and bumped price are obtained together from `Option::vol_ladder`, which prices the
+ * two scenarios concurrently on the mesh of the option. If a Newton step leaves
+ * the bracket of volatilities known to enclose the root, the vega vanishes or Newton does not
+ * converge in `max_newton` iterations, the search continues with Brent's method on the bracket.
+ *
+ * One `Option` is built per quote; the iterations reuse its mesh, its curve lookups and its
+ * schedules, and the scratch memory of the thread-local arena.
+ */
+class ImpliedVol {
+
+    unsigned int time_mesh_;
+    unsigned int spot_mesh_;
+    InterestRateHandle curve_;
+    PSORSettings psor_;
+    ImpliedVolSettings settings_;
+
+public:
+    /**
+     * @brief Constructs the solver.
+     * @param time_mesh Number of time steps in the grid.
+     * @param spot_mesh Number of spot steps in the grid.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param settings Parameters of the search.
+     * @param psor Settings of the projected SOR solver used for American exercise.
+     */
+    ImpliedVol(unsigned int time_mesh, unsigned int spot_mesh, InterestRateHandle rate_curve,
+        const ImpliedVolSettings& settings = ImpliedVolSettings(), const PSORSettings& psor = PSORSettings());
+
+    /**
+     * @brief Computes the Black-Scholes implied volatility of a quote, used as the initial guess.
+     * @param quote Option quote.
+     * @return Black-Scholes implied volatility, clipped to the bracket.
+     */
+    double initial_guess(const VolQuote& quote) const;
+
+    /**
+     * @brief Computes the implied volatility of one quote.
+     * @param quote Option quote.
+     * @return Implied volatility and convergence information.
+     */
+    ImpliedVolResult solve(const VolQuote& quote) const;
+
+    /**
+     * @brief Computes the implied volatilities of a chain of quotes in parallel.
+     * @param quotes Option quotes.
+     * @return One result per quote, in the same order.
+     */
+    std::vector<ImpliedVolResult> solve(const std::vector<VolQuote>& quotes) const;
+};
\ No newline at end of file
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "OptionExceptions.h"
+#include <memory>
 #include <vector>
 
  /**
@@ -40,7 +41,13 @@ public:
      *
      * @param interest_rate Vector of (time, rate) pairs representing the interest rate curve.
      */
-    InterestRate(std::vector<std::pair<double, double>> interest_rate) : interest_rate_(interest_rate) {}
+    InterestRate(std::vector<std::pair<double, double>> interest_rate) : interest_rate_(std::move(interest_rate)) {}
+
+    /**
+     * @brief Returns the (time, rate) pillars of the curve.
+     * @return Read-only reference to the curve points.
+     */
+    const std::vector<std::pair<double, double>>& points() const { return interest_rate_; }
 
     /**
      * @brief Evaluates the interest rate at a given time.
@@ -64,4 +71,12 @@ public:
      * @return The computed integral value from \( 0 \) to \( t_0 \).
      */
     double integral(double t0) const;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Shared, immutable handle to an interest rate curve.
+ *
+ * Options built on the same market data (e.g. the bumped copies used for the Greeks)
+ * share one curve instead of copying its points.
+ */
+typedef std::shared_ptr<const InterestRate> InterestRateHandle;
\ No newline at end of file
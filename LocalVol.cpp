@@ -0,0 +1,152 @@
+/**
+ * @file LocalVol.cpp
+ * @brief Contains the construction and the interpolation of local volatility surfaces.
+ */
+
+#include "LocalVol.h"
+
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Checks that a set of pillars is non-empty and strictly increasing.
+     * @param pillars Pillars to check.
+     */
+    void check_pillars(const std::vector<double>& pillars) {
+        if (pillars.empty()) throw InvalidLocalVol(0);
+        for (size_t ii = 1; ii < pillars.size(); ii++) {
+            if (!(pillars[ii] > pillars[ii - 1])) throw InvalidLocalVol(pillars[ii]);
+        }
+    }
+
+    /**
+     * @brief Locates a point among the pillars for linear interpolation.
+     *
+     * Points outside the pillars are clamped to the first or last one.
+     *
+     * @param pillars Increasing pillars.
+     * @param x Point to locate.
+     * @param w Weight of the pillar after the returned one.
+     * @return Index of the pillar at or before `x`.
+     */
+    size_t locate(const std::vector<double>& pillars, double x, double& w) {
+        w = 0;
+        if (x <= pillars.front()) return 0;
+        if (x >= pillars.back()) return pillars.size() - 1;
+        size_t ii = std::upper_bound(pillars.begin(), pillars.end(), x) - pillars.begin() - 1;
+        w = (x - pillars[ii]) / (pillars[ii + 1] - pillars[ii]);
+        return ii;
+    }
+}
+
+/**
+ * @brief Constructs a surface from its pillars.
+ * @param spots Spot pillars, strictly increasing.
+ * @param times Time pillars, strictly increasing.
+ * @param vols Volatilities, time by time: `vols[i * spots.size() + j]` is \( \sigma(S_j, t_i) \).
+ */
+LocalVol::LocalVol(std::vector<double> spots, std::vector<double> times, std::vector<double> vols)
+    : spots_(std::move(spots)), times_(std::move(times)), vols_(std::move(vols)) {
+    check_pillars(spots_);
+    check_pillars(times_);
+    if (vols_.size() != spots_.size() * times_.size()) throw InvalidLocalVol(static_cast<double>(vols_.size()));
+    for (double vol : vols_) {
+        if (!(vol > 0)) throw InvalidLocalVol(vol);
+    }
+}
+
+/**
+ * @brief Evaluates the local volatility by bilinear interpolation.
+ *
+ * Outside the pillars the surface is extended with the value of the nearest pillar.
+ *
+ * @param S Spot price.
+ * @param t Time.
+ * @return Interpolated volatility \( \sigma(S, t) \).
+ */
+double LocalVol::operator()(double S, double t) const {
+    double ws, wt;
+    size_t jj = locate(spots_, S, ws);
+    size_t ii = locate(times_, t, wt);
+    size_t m = spots_.size();
+
+    const double* row = vols_.data() + ii * m;
+    double lo = ws > 0 ? (1 - ws) * row[jj] + ws * row[jj + 1] : row[jj];
+    if (wt == 0) return lo;
+    row += m;
+    double hi = ws > 0 ? (1 - ws) * row[jj] + ws * row[jj + 1] : row[jj];
+    return (1 - wt) * lo + wt * hi;
+}
+
+/**
+ * @brief Tabulates \( \sigma^2 \) on a uniform grid.
+ *
+ * Bilinear interpolation is separable: each time pillar is first interpolated on the spot nodes,
+ * then every level is a blend of the two pillar rows around it, so a level costs two
+ * multiplications per node and no search.
+ *
+ * @param S_min Spot of the first node.
+ * @param dS Spot step; node \( j \) is at \( S = S_{min} + j \, dS \).
+ * @param nodes Number of spot nodes.
+ * @param dT Time step; level \( i \) is at \( t = i \, dT \).
+ * @param levels Number of time levels.
+ * @param times Times of further rows, appended after the levels.
+ * @return Squared volatilities, level by level: entry `i * nodes + j` is \( \sigma^2(S_{min} + j \, dS, i \, dT) \),
+ * then one row per entry of `times`.
+ */
+std::vector<double> LocalVol::variance_table(double S_min, double dS, size_t nodes, double dT, size_t levels, const std::vector<double>& times) const {
+    size_t m = spots_.size();
+    std::vector<double> rows(times_.size() * nodes);
+    for (size_t jj = 0; jj < nodes; jj++) {
+        double ws;
+        size_t kk = locate(spots_, S_min + jj * dS, ws);
+        for (size_t ii = 0; ii < times_.size(); ii++) {
+            const double* row = vols_.data() + ii * m;
+            rows[ii * nodes + jj] = ws > 0 ? (1 - ws) * row[kk] + ws * row[kk + 1] : row[kk];
+        }
+    }
+
+    std::vector<double> table((levels + times.size()) * nodes);
+    for (size_t ii = 0; ii < levels + times.size(); ii++) {
+        double wt;
+        size_t kk = locate(times_, ii < levels ? ii * dT : times[ii - levels], wt);
+        const double* lo = rows.data() + kk * nodes;
+        const double* hi = wt > 0 ? lo + nodes : lo;
+        double* out = table.data() + ii * nodes;
+        for (size_t jj = 0; jj < nodes; jj++) {
+            double vol = (1 - wt) * lo[jj] + wt * hi[jj];
+            out[jj] = vol * vol;
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Returns a copy of the surface with every volatility shifted by the same amount.
+ * @param shift Absolute volatility shift.
+ * @return Handle to the shifted surface.
+ */
+LocalVolHandle LocalVol::shifted(double shift) const {
+    std::vector<double> vols = vols_;
+    for (double& vol : vols) {
+        vol += shift;
+    }
+    return std::make_shared<const LocalVol>(spots_, times_, std::move(vols));
+}
+
+/**
+ * @brief Returns a copy of the surface with every volatility multiplied by the same factor.
+ *
+ * Unlike a shift, a positive factor keeps every volatility positive.
+ *
+ * @param factor Positive factor.
+ * @return Handle to the scaled surface.
+ */
+LocalVolHandle LocalVol::scaled(double factor) const {
+    if (!(factor > 0)) throw InvalidLocalVol(factor);
+    std::vector<double> vols = vols_;
+    for (double& vol : vols) {
+        vol *= factor;
+    }
+    return std::make_shared<const LocalVol>(spots_, times_, std::move(vols));
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ * @file LocalVol.h
+ * @brief Class to represent a local volatility surface \( \sigma(S, t) \).
+ */
+
+#pragma once
+
+#include "OptionExceptions.h"
+#include <memory>
+#include <vector>
+
+class LocalVol;
+
+/**
+ * @brief Shared, immutable handle to a local volatility surface.
+ */
+typedef std::shared_ptr<const LocalVol> LocalVolHandle;
+
+/**
+ * @class LocalVol
+ * @brief Local volatility surface given on a grid of spot and time pillars.
+ *
+ * The surface is bilinear between the pillars and flat outside them. Times are measured on the
+ * same clock as the interest rate curve, from the initial time of the option.
+ */
+class LocalVol {
+
+    std::vector<double> spots_;
+    std::vector<double> times_;
+    std::vector<double> vols_;
+
+public:
+    /**
+     * @brief Constructs a surface from its pillars.
+     *
+     * @param spots Spot pillars, strictly increasing.
+     * @param times Time pillars, strictly increasing.
+     * @param vols Volatilities, time by time: `vols[i * spots.size() + j]` is \( \sigma(S_j, t_i) \).
+     */
+    LocalVol(std::vector<double> spots, std::vector<double> times, std::vector<double> vols);
+
+    /**
+     * @brief Returns the spot pillars of the surface.
+     * @return Read-only reference to the spot pillars.
+     */
+    const std::vector<double>& spots() const { return spots_; }
+
+    /**
+     * @brief Returns the time pillars of the surface.
+     * @return Read-only reference to the time pillars.
+     */
+    const std::vector<double>& times() const { return times_; }
+
+    /**
+     * @brief Returns the volatilities at the pillars, time by time.
+     * @return Read-only reference to the volatilities.
+     */
+    const std::vector<double>& vols() const { return vols_; }
+
+    /**
+     * @brief Evaluates the local volatility.
+     * @param S Spot price.
+     * @param t Time.
+     * @return Interpolated volatility \( \sigma(S, t) \).
+     */
+    double operator()(double S, double t) const;
+
+    /**
+     * @brief Tabulates \( \sigma^2 \) on a uniform grid.
+     * @param S_min Spot of the first node.
+     * @param dS Spot step; node \( j \) is at \( S = S_{min} + j \, dS \).
+     * @param nodes Number of spot nodes.
+     * @param dT Time step; level \( i \) is at \( t = i \, dT \).
+     * @param levels Number of time levels.
+     * @param times Times of further rows, appended after the levels.
+     * @return Squared volatilities, level by level: entry `i * nodes + j` is \( \sigma^2(S_{min} + j \, dS, i \, dT) \),
+     * then one row per entry of `times`.
+     */
+    std::vector<double> variance_table(double S_min, double dS, size_t nodes, double dT, size_t levels,
+        const std::vector<double>& times = std::vector<double>()) const;
+
+    /**
+     * @brief Returns a copy of the surface with every volatility shifted by the same amount.
+     * @param shift Absolute volatility shift.
+     * @return Handle to the shifted surface.
+     */
+    LocalVolHandle shifted(double shift) const;
+
+    /**
+     * @brief Returns a copy of the surface with every volatility multiplied by the same factor.
+     * @param factor Positive factor.
+     * @return Handle to the scaled surface.
+     */
+    LocalVolHandle scaled(double factor) const;
+};
\ No newline at end of file
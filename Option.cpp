@@ -4,11 +4,15 @@
  */
 
 #include "Option.h"
+#include "ThreadPool.h"
 #include "Tridiag.h"
 
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
+#include <limits>
+#include <sstream>
 
  /**
   * @brief Multiplies a scalar with a vector.
@@ -19,7 +23,7 @@
   * @param v Vector to be scaled.
   * @return Scaled vector.
   */
-std::vector<double> operator*(double k, std::vector<double> v) {
+ScratchVector operator*(double k, ScratchVector v) {
     size_t n = v.size();
     for (size_t ii = 0; ii < n; ii++) {
         v[ii] *= k;
@@ -36,7 +40,7 @@ std::vector<double> operator*(double k, std::vector<double> v) {
  * @param v Vector to subtract from the scalar.
  * @return Resulting vector.
  */
-std::vector<double> operator-(double k, std::vector<double> v) {
+ScratchVector operator-(double k, ScratchVector v) {
     size_t n = v.size();
     for (size_t ii = 0; ii < n; ii++) {
         v[ii] = k - v[ii];
@@ -53,7 +57,7 @@ std::vector<double> operator-(double k, std::vector<double> v) {
  * @param v Vector to which the scalar is added.
  * @return Resulting vector.
  */
-std::vector<double> operator+(double k, std::vector<double> v) {
+ScratchVector operator+(double k, ScratchVector v) {
     size_t n = v.size();
     for (size_t ii = 0; ii < n; ii++) {
         v[ii] = k + v[ii];
@@ -64,19 +68,19 @@ std::vector<double> operator+(double k, std::vector<double> v) {
 /**
  * @brief Subtracts two vectors element-wise.
  *
- * Computes the difference between corresponding elements of two vectors.
+ * Computes the difference between corresponding elements of two vectors,
+ * reusing the storage of the first one.
  *
  * @param v1 First vector.
  * @param v2 Second vector to subtract.
  * @return Resulting vector.
  */
-std::vector<double> operator-(std::vector<double> v1, std::vector<double> v2) {
+ScratchVector operator-(ScratchVector v1, const ScratchVector& v2) {
     size_t n = v1.size();
-    std::vector<double> res(n);
     for (size_t ii = 0; ii < n; ii++) {
-        res[ii] = v1[ii] - v2[ii];
+        v1[ii] -= v2[ii];
     }
-    return res;
+    return v1;
 }
 
 /**
@@ -89,7 +93,7 @@ std::vector<double> operator-(std::vector<double> v1, std::vector<double> v2) {
  * @param p2 Pair of scalars to add.
  * @return Modified vector.
  */
-std::vector<double> operator+(std::vector<double> v1, std::pair<double, double> p2) {
+ScratchVector operator+(ScratchVector v1, std::pair<double, double> p2) {
     v1[0] += p2.first;
     v1[v1.size() - 1] += p2.second;
     return v1;
@@ -106,7 +110,7 @@ std::vector<double> operator+(std::vector<double> v1, std::pair<double, double>
  * @param v1 Input vector.
  * @return Euclidean norm.
  */
-double norm(std::vector<double> v1) {
+double norm(const ScratchVector& v1) {
     size_t n = v1.size();
     double som = 0;
     for (size_t ii = 0; ii < n; ii++) {
@@ -116,10 +120,12 @@ double norm(std::vector<double> v1) {
 }
 
 /**
- * @brief Constructs an Option object and validates input parameters.
+ * @brief Constructs an Option object from the points of an interest rate curve.
  *
- * Initializes the option with specified contract type, exercise type, maturity, strike price,
- * and other parameters required for the finite difference method.
+ * The curve points are moved into a shared curve handle and the construction is delegated
+ * to the handle-based constructor. The projected SOR solver keeps the relaxation `w` fixed and
+ * starts each step from the previous level, as `PSORSettings::baseline()`; the adaptive modes
+ * are selected through the `PSORSettings` of the handle-based constructors.
  *
  * @param contract_type Type of option: 1 for Call, -1 for Put.
  * @param exercise_type Exercise type: 1 for European, 0 for American.
@@ -132,41 +138,575 @@ double norm(std::vector<double> v1) {
  * @param interest_rate Interest rate curve as a vector of (time, rate) pairs.
  * @param volatility Volatility of the underlying asset.
  * @param tol Tolerance for iterative methods.
- * @param w Relaxation parameter for iterative methods.
+ * @param w Relaxation parameter for iterative methods, used as a fixed value.
  */
 Option::Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, std::vector<std::pair<double, double>> interest_rate, double volatility, double tol, double w)
-    : contract_type_(contract_type), exercise_type_(exercise_type), T_(T), K_(K), T0_(T0), S0_(S0), volatility_(volatility),
-    time_mesh_(time_mesh), spot_mesh_(spot_mesh), interest_rate_(interest_rate), tol_(tol), w_(w) {
+    : Option(contract_type, exercise_type, T, K, T0, time_mesh, spot_mesh, S0, std::make_shared<const InterestRate>(std::move(interest_rate)), volatility, PSORSettings(tol, w).baseline()) {}
+
+/**
+ * @brief Constructs an Option object and validates input parameters.
+ *
+ * Initializes the option with specified contract type, exercise type, maturity, strike price,
+ * and other parameters required for the finite difference method.
+ *
+ * @param contract_type Type of option: 1 for Call, -1 for Put.
+ * @param exercise_type Exercise type: 1 for European, 0 for American.
+ * @param T Maturity time.
+ * @param K Strike price.
+ * @param T0 Start time.
+ * @param time_mesh Number of time steps.
+ * @param spot_mesh Number of spot price steps.
+ * @param S0 Current spot price.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param volatility Volatility of the underlying asset.
+ * @param psor Settings of the projected SOR solver used for American exercise.
+ * @param S_max Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+ * @param dividends Cash dividends of the underlying asset.
+ * @param dividend_yield Continuous dividend yield curve \( q(t) \); null for no yield.
+ * @param repo Repo (stock borrow) rate curve, which lowers the drift like the dividend yield; null for none.
+ * @param barrier Barrier of the option; none by default.
+ * @param exercise_dates Exercise times of a Bermudan option (exercise type 0); empty for exercise at every time step.
+ */
+Option::Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, InterestRateHandle rate_curve, double volatility, const PSORSettings& psor, double S_max, std::vector<Dividend> dividends,
+    InterestRateHandle dividend_yield, InterestRateHandle repo, const Barrier& barrier,
+    std::vector<double> exercise_dates)
+    : contract_type_(contract_type), exercise_type_(exercise_type), T_(T), K_(K), T0_(T0), S0_(S0), S_max_(S_max > 0 ? S_max : 5 * S0), volatility_(volatility),
+    time_mesh_(time_mesh), spot_mesh_(spot_mesh), curve(std::move(rate_curve)), dividends_(std::move(dividends)),
+    dividend_yield_(std::move(dividend_yield)), repo_(std::move(repo)), psor_(psor), psor_sweeps_(0),
+    barrier_(barrier), mesh_input_(spot_mesh), S_max_input_(S_max), S_min_(0), j0_(0), barrier_node_(0), zero_payoff_(false),
+    exercise_dates_(std::move(exercise_dates)) {
+    setup();
+}
+
+/**
+ * @brief Constructs an Option object under a local volatility surface and validates input parameters.
+ *
+ * The coefficients of the scheme use \( \sigma^2 \) at each node and time level, tabulated once
+ * from the surface; the scalar volatility is set to \( \sigma(S_0, 0) \) and is the reference
+ * of the relative bumps of `vega` and `volga`.
+ *
+ * @param contract_type Type of option: 1 for Call, -1 for Put.
+ * @param exercise_type Exercise type: 1 for European, 0 for American.
+ * @param T Maturity time.
+ * @param K Strike price.
+ * @param T0 Start time.
+ * @param time_mesh Number of time steps.
+ * @param spot_mesh Number of spot price steps.
+ * @param S0 Current spot price.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param local_vol Shared, immutable local volatility surface.
+ * @param psor Settings of the projected SOR solver used for American exercise.
+ * @param S_max Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+ * @param dividends Cash dividends of the underlying asset.
+ * @param dividend_yield Continuous dividend yield curve \( q(t) \); null for no yield.
+ * @param repo Repo (stock borrow) rate curve, which lowers the drift like the dividend yield; null for none.
+ * @param barrier Barrier of the option; none by default.
+ * @param exercise_dates Exercise times of a Bermudan option (exercise type 0); empty for exercise at every time step.
+ */
+Option::Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, InterestRateHandle rate_curve, LocalVolHandle local_vol, const PSORSettings& psor, double S_max, std::vector<Dividend> dividends,
+    InterestRateHandle dividend_yield, InterestRateHandle repo, const Barrier& barrier,
+    std::vector<double> exercise_dates)
+    : contract_type_(contract_type), exercise_type_(exercise_type), T_(T), K_(K), T0_(T0), S0_(S0), S_max_(S_max > 0 ? S_max : 5 * S0),
+    volatility_(local_vol ? (*local_vol)(S0, 0) : 0), local_vol_(std::move(local_vol)),
+    time_mesh_(time_mesh), spot_mesh_(spot_mesh), curve(std::move(rate_curve)), dividends_(std::move(dividends)),
+    dividend_yield_(std::move(dividend_yield)), repo_(std::move(repo)), psor_(psor), psor_sweeps_(0),
+    barrier_(barrier), mesh_input_(spot_mesh), S_max_input_(S_max), S_min_(0), j0_(0), barrier_node_(0), zero_payoff_(false),
+    exercise_dates_(std::move(exercise_dates)) {
+    if (!local_vol_) throw InvalidLocalVol(0);
+    setup();
+}
+
+/**
+ * @brief Validates the parameters, sets up the mesh and prices the option.
+ */
+void Option::setup() {
     if (contract_type_ != 1 && contract_type_ != -1) throw InvalidContractType(contract_type_);
     if (exercise_type_ != 1 && exercise_type_ != 0) throw InvalidExerciseType(exercise_type_);
-    if (T_ < T0 || T < 0) throw InvalidMaturity();
+    if (T_ < T0_ || T_ < 0) throw InvalidMaturity();
     if (K_ <= 0) throw InvalidStrike(K_);
     if (time_mesh_ <= 0) throw InvalidTimeMesh(time_mesh_);
     if (spot_mesh_ <= 0) throw InvalidSpotMesh(spot_mesh_);
     if (S0_ <= 0) throw InvalidSpot(S0_);
     if (volatility_ <= 0) throw InvalidVolatility(volatility_);
+    if (S_max_ <= S0_) throw InvalidDomain(S_max_);
 
     dT = (T_ - T0_) / time_mesh_;
-    dS = (5 * S0_) / spot_mesh_;
-
-    curve = InterestRate(interest_rate_);
+    if (barrier_.type != BarrierType::None) setup_barrier();
+    else dS = S_max_ / spot_mesh_;
 
-    if (contract_type == 1) { F0 = 0, FM = 5 * S0; }
-    else { F0 = K, FM = 0; }
+    set_contract(contract_type_, K_);
 
+    fill_jumps();
+    fill_schedules();
+    if (local_vol_) fill_local_vol();
+    fill_curves();
     create_grid();
     solve();
 }
 
+/**
+ * @brief Sets up the spot mesh of a barrier option.
+ *
+ * The spot step is chosen so that both the barrier and \( S_0 \) are nodes, with about
+ * `spot_mesh_` steps across the domain of a knock-out:
+ * - up barriers: \( [S_{min}, B] \), where \( S_{min} \in [0, \Delta S) \) is the lowest node above 0;
+ * - down barriers: \( [B, B + M \Delta S] \), with \( B + M \Delta S \) close to the `S_max` of the constructor.
+ *
+ * The knock-out domain ends at the barrier, where the value is the rebate, so all the nodes
+ * resolve the region the option lives in. A knock-in also needs the vanilla option beyond the
+ * barrier: its grid adds the nodes from the barrier to \( S_{min} \) (down) or to `S_max` (up), and
+ * `barrier_node_` is the index of the barrier.
+ *
+ * A discretely monitored barrier can be crossed between two monitoring times, so its domain is
+ * the vanilla one, \( [S_{min}, S_{max}] \) with about `spot_mesh_` steps. \( S_0 \) is still a node but
+ * the barrier lies halfway between two nodes: the knock-out makes the value discontinuous there,
+ * and a discontinuity on a node would shift the effective barrier by about \( \Delta S / 2 \).
+ * `barrier_node_` is then the last node knocked out, next to the barrier.
+ */
+void Option::setup_barrier() {
+    double B = barrier_.level;
+    bool up = barrier_.type == BarrierType::UpOut || barrier_.type == BarrierType::UpIn;
+    bool in = barrier_.type == BarrierType::UpIn || barrier_.type == BarrierType::DownIn;
+    if (!(B > 0) || (up ? B <= S0_ : B >= S0_)) throw InvalidBarrier(B);
+    if (in && barrier_.rebate != 0) throw InvalidBarrier(barrier_.rebate);
+    bool discrete = !barrier_.monitoring.empty();
+    if ((barrier_.type == BarrierType::UpIn || discrete) && S_max_ <= B) throw InvalidDomain(S_max_);
+
+    double width = discrete ? S_max_ : up ? B : S_max_ - B;
+    double gap = std::fabs(S0_ - B);
+    double steps = std::max(1.0, std::round(gap * spot_mesh_ / width));
+    if (steps >= spot_mesh_) throw InvalidSpotMesh(spot_mesh_);
+
+    if (discrete) {
+        dS = gap / (steps + 0.5);
+        S_min_ = S0_ - std::floor(S0_ / dS + 1e-9) * dS;
+        double x = (B - S_min_) / dS;
+        barrier_node_ = static_cast<size_t>(up ? std::ceil(x) : std::floor(x));
+        spot_mesh_ = static_cast<unsigned int>(std::ceil((S_max_ - S_min_) / dS - 1e-9));
+        S_max_ = S_min_ + spot_mesh_ * dS;
+        j0_ = S_min_ / dS;
+        return;
+    }
+    dS = gap / steps;
+
+    size_t below = static_cast<size_t>(std::floor(B / dS + 1e-9));
+    if (B - below * dS < 0) below--;
+    if (up) {
+        size_t above = in ? static_cast<size_t>(std::ceil((S_max_ - B) / dS - 1e-9)) : 0;
+        S_min_ = B - below * dS;
+        barrier_node_ = below;
+        spot_mesh_ = static_cast<unsigned int>(below + above);
+        S_max_ = B + above * dS;
+    }
+    else {
+        S_min_ = in ? B - below * dS : B;
+        barrier_node_ = in ? below : 0;
+        S_max_ = B + spot_mesh_ * dS;
+        spot_mesh_ += static_cast<unsigned int>(barrier_node_);
+    }
+    j0_ = S_min_ / dS;
+}
+
+/**
+ * @brief Returns the Dirichlet value of the lowest node at a time level.
+ *
+ * Used on domains that do not start at \( S = 0 \) or end at a barrier: the rebate (or the values
+ * of `edge_`) at a down barrier, 0 on the far side of a knock-in, and otherwise the deep in- or
+ * out-of-the-money value at \( S_{min} \). Below a discretely monitored down barrier the rebate
+ * stands for the value of being knocked out on the next monitoring time.
+ *
+ * @param i Time level, or index of a stop after the last level.
+ * @return Option value at \( S_{min} \).
+ */
+double Option::lower_boundary(size_t i) const {
+    if (barrier_.type == BarrierType::DownOut) return edge_.empty() ? barrier_.rebate : edge_[i];
+    if (zero_payoff_ || contract_type_ == 1) return 0;
+    return exercise_type_ ? K_ * discounts_[i] - S_min_ * carries_[i] : K_ - S_min_;
+}
+
+/**
+ * @brief Returns the Dirichlet value of the highest node at a time level.
+ *
+ * The rebate (or the values of `edge_`) at an up barrier, 0 on the far side of a knock-in, and
+ * otherwise the deep in- or out-of-the-money value at \( S_{max} \).
+ *
+ * @param i Time level, or index of a stop after the last level.
+ * @return Option value at \( S_{max} \).
+ */
+double Option::upper_boundary(size_t i) const {
+    if (barrier_.type == BarrierType::UpOut) return edge_.empty() ? barrier_.rebate : edge_[i];
+    if (zero_payoff_ || contract_type_ == -1) return 0;
+    return exercise_type_ ? S_max_ * carries_[i] - K_ * discounts_[i] : S_max_ - K_;
+}
+
+/**
+ * @brief Prices a knock-in option from the vanilla option and a truncated solve.
+ *
+ * Once the barrier is hit the option is the vanilla one, so beyond the barrier the grid holds the
+ * vanilla values. Before the barrier it is a claim paying nothing at expiry and worth the vanilla
+ * option on the barrier: it is solved on the truncated domain with the vanilla values at the
+ * barrier node as Dirichlet condition and no early exercise (the holder has nothing to exercise
+ * before the knock-in). For European exercise this is the in-out parity \( V_{in} = V - V_{out} \)
+ * applied node by node; for American exercise, where the parity does not hold, it gives the
+ * value of receiving the American option at the hitting time.
+ *
+ * With discrete monitoring the claim lives on the whole domain: on each monitoring time the nodes
+ * beyond the barrier take the vanilla values (see `knock_out`), and between those times it is
+ * solved with European steps.
+ *
+ * The vanilla pricing keeps the stops of the option, monitoring times included, so that its grid
+ * also holds the values the claim needs at those times. The PSOR statistics are those of the
+ * vanilla pricing.
+ */
+void Option::solve_knock_in() {
+    bool down = barrier_.type == BarrierType::DownIn;
+
+    Option vanilla(*this);
+    vanilla.barrier_ = Barrier();
+    vanilla.monitor_levels_.clear();
+    for (Stop& stop : vanilla.stops_) {
+        stop.monitor = false;
+    }
+    vanilla.solve();
+
+    if (!monitor_levels_.empty()) {
+        Option claim(*this);
+        claim.barrier_.type = down ? BarrierType::DownOut : BarrierType::UpOut;
+        claim.exercise_type_ = 1;
+        claim.exercise_levels_.clear();
+        claim.zero_payoff_ = true;
+        claim.knock_values_ = vanilla.grid;
+        claim.edge_.resize(instants());
+        for (size_t ii = 0; ii < instants(); ii++) {
+            claim.edge_[ii] = vanilla.node(down ? 0 : spot_mesh_, ii);
+        }
+        claim.solve();
+
+        grid = std::move(claim.grid);
+        psor_sweeps_ = vanilla.psor_sweeps_;
+        psor_steps_ = std::move(vanilla.psor_steps_);
+        warnings_ = std::move(vanilla.warnings_);
+        return;
+    }
+
+    Option inner(*this);
+    inner.barrier_ = Barrier(down ? BarrierType::DownOut : BarrierType::UpOut, barrier_.level);
+    inner.exercise_type_ = 1;
+    inner.zero_payoff_ = true;
+    if (down) {
+        inner.S_min_ = S_min_ + barrier_node_ * dS;
+        inner.j0_ = j0_ + barrier_node_;
+        inner.spot_mesh_ = spot_mesh_ - static_cast<unsigned int>(barrier_node_);
+    }
+    else {
+        inner.S_max_ = S_min_ + barrier_node_ * dS;
+        inner.spot_mesh_ = static_cast<unsigned int>(barrier_node_);
+    }
+    inner.edge_.resize(instants());
+    for (size_t ii = 0; ii < instants(); ii++) {
+        inner.edge_[ii] = vanilla.node(barrier_node_, ii);
+    }
+    if (local_vol_) inner.fill_local_vol();
+    inner.create_grid();
+    inner.solve();
+
+    grid = std::move(vanilla.grid);
+    size_t offset = down ? barrier_node_ : 0;
+    for (size_t ii = 0; ii < instants(); ii++) {
+        std::copy(inner.level(ii), inner.level(ii) + inner.spot_mesh_ + 1, level(ii) + offset);
+    }
+    psor_sweeps_ = vanilla.psor_sweeps_;
+    psor_steps_ = std::move(vanilla.psor_steps_);
+    warnings_ = std::move(vanilla.warnings_);
+}
+
 /**
  * @brief Creates the grid for option pricing.
  *
- * Initializes a 2D grid of size `(spot_mesh_ + 1) x time_mesh_` with zeros
- * to store intermediate and final option values during the finite difference computation.
+ * Initializes a grid of `(spot_mesh_ + 1) x time_mesh_` zeros to store intermediate and final
+ * option values during the finite difference computation. The values are stored by time level:
+ * the spot nodes of one level are contiguous. One row per stop follows the last level, with the
+ * values at the time of the stop.
  */
 void Option::create_grid() {
-    std::vector<std::vector<double>> matrix(spot_mesh_ + 1, std::vector<double>(time_mesh_, 0.0));
-    grid = matrix;
+    grid.assign(static_cast<size_t>(spot_mesh_ + 1) * instants(), 0.0);
+}
+
+/**
+ * @brief Tabulates \( \sigma^2 \) of the local volatility surface on the nodes of the grid.
+ *
+ * The table has the layout of the grid, one row of `spot_mesh_ + 1` values per time level, with
+ * level \( i \) at time \( i \, \Delta T \) on the clock of the rate curve, then one row per stop.
+ * The coefficient assembly then reads a contiguous row instead of interpolating the surface.
+ */
+void Option::fill_local_vol() {
+    std::vector<double> times;
+    for (const Stop& stop : stops_) {
+        times.push_back(stop.time);
+    }
+    sigma2_ = local_vol_->variance_table(S_min_, dS, spot_mesh_ + 1, dT, time_mesh_, times);
+}
+
+/**
+ * @brief Tabulates the term structures on the time levels of the grid.
+ *
+ * For each level \( i \), at time \( t_i = i \, \Delta T \), stores the short rate \( r \), the drift
+ * \( r - q - b \) with \( q \) the dividend yield and \( b \) the repo rate, the discount factor
+ * \( e^{-\int r} \) and the carry factor \( e^{-\int (q + b)} \) of the boundary conditions, the
+ * integrals being those of `InterestRate::integral`. The stops have their own entries, after
+ * those of the levels. The sweeps then read one entry per level and never evaluate a curve.
+ */
+void Option::fill_curves() {
+    rates_.resize(instants());
+    drifts_.resize(instants());
+    discounts_.resize(instants());
+    carries_.resize(instants());
+    for (size_t ii = 0; ii < instants(); ii++) {
+        double t = time_at(ii);
+        double q = 0, Q = 0;
+        if (dividend_yield_) {
+            q += (*dividend_yield_)(t);
+            Q += dividend_yield_->integral(t);
+        }
+        if (repo_) {
+            q += (*repo_)(t);
+            Q += repo_->integral(t);
+        }
+        rates_[ii] = (*curve)(t);
+        drifts_[ii] = rates_[ii] - q;
+        discounts_[ii] = std::exp(-curve->integral(t));
+        carries_[ii] = std::exp(-Q);
+    }
+}
+
+/**
+ * @brief Locates a time on the time levels.
+ *
+ * Times within rounding of a level, such as a date given as a multiple of the time step, are on it.
+ *
+ * @param t Time, from 0.
+ * @param k Receives the level of `t` if it is on one, else the last level before it.
+ * @return True if `t` is on a time level.
+ */
+bool Option::locate_level(double t, size_t& k) const {
+    double x = t / dT;
+    double r = std::round(x);
+    if (std::fabs(x - r) <= 1e-9 * std::max(1.0, r)) {
+        k = static_cast<size_t>(r);
+        return true;
+    }
+    k = static_cast<size_t>(std::floor(x));
+    return false;
+}
+
+/**
+ * @brief Returns the stop at a time between two levels, adding it if there is none.
+ *
+ * The stops are kept in increasing order of time; events at the same time share one stop.
+ *
+ * @param t Time of the event.
+ * @param k Time level before `t`.
+ * @return Index of the stop in `stops_`.
+ */
+size_t Option::add_stop(double t, size_t k) {
+    size_t ss = 0;
+    while (ss < stops_.size() && stops_[ss].time < t) ss++;
+    if (ss == stops_.size() || stops_[ss].time != t) {
+        stops_.insert(stops_.begin() + ss, Stop{ t, k, 0.0, false, false });
+    }
+    return ss;
+}
+
+/**
+ * @brief Returns the stops between a time level and the next one.
+ * @param k Time level.
+ * @return Range `[first, second)` of indices in `stops_`, empty if the step from `k + 1` to `k` is not split.
+ */
+std::pair<size_t, size_t> Option::stop_range(size_t k) const {
+    size_t lo = 0;
+    while (lo < stops_.size() && stops_[lo].level < k) lo++;
+    size_t hi = lo;
+    while (hi < stops_.size() && stops_[hi].level == k) hi++;
+    return std::make_pair(lo, hi);
+}
+
+/**
+ * @brief Returns the cash dividend paid at a time level or a stop.
+ * @param i Time level, or index of a stop after the last level.
+ * @return Sum of the dividends paid at that time, 0 if none.
+ */
+double Option::dividend_at(size_t i) const {
+    if (i >= time_mesh_) return stops_[i - time_mesh_].dividend;
+    return jumps_.empty() ? 0.0 : jumps_[i];
+}
+
+/**
+ * @brief Tells whether a Bermudan option can be exercised at a time level or a stop.
+ * @param i Time level, or index of a stop after the last level.
+ * @return True on an exercise date.
+ */
+bool Option::exercise_at(size_t i) const {
+    if (i >= time_mesh_) return stops_[i - time_mesh_].exercise;
+    return !exercise_levels_.empty() && exercise_levels_[i];
+}
+
+/**
+ * @brief Tells whether a discrete barrier is observed at a time level or a stop.
+ * @param i Time level, or index of a stop after the last level.
+ * @return True on a monitoring time.
+ */
+bool Option::monitor_at(size_t i) const {
+    if (i >= time_mesh_) return stops_[i - time_mesh_].monitor;
+    return !monitor_levels_.empty() && monitor_levels_[i];
+}
+
+/**
+ * @brief Assigns the cash dividends to the time levels of the grid.
+ *
+ * A dividend on a time level is paid on that level; dividends falling on the same level are added
+ * together. A dividend between two levels gets a stop at its ex-dividend time: the step across it
+ * is split in two sub-steps ending on the ex-dividend time, so the date is kept exactly while the
+ * mesh stays uniform everywhere else. Dividends before the initial time or on the last level (the
+ * payoff) and after it are not paid during the life of the option and are ignored; a dividend on
+ * the first level is paid, \( S_0 \) being the cum-dividend spot.
+ *
+ * Called first when the option is set up: it also clears the stops of the schedules.
+ */
+void Option::fill_jumps() {
+    jumps_.clear();
+    stops_.clear();
+    for (const Dividend& dividend : dividends_) {
+        if (!(dividend.amount >= 0)) throw InvalidDividend(dividend.amount);
+        size_t k;
+        if (!(dividend.time >= 0)) continue;
+        bool on_level = locate_level(dividend.time, k);
+        if (k >= time_mesh_ - 1) continue;
+        if (!on_level) {
+            stops_[add_stop(dividend.time, k)].dividend += dividend.amount;
+            continue;
+        }
+        if (jumps_.empty()) jumps_.assign(time_mesh_, 0.0);
+        jumps_[k] += dividend.amount;
+    }
+}
+
+/**
+ * @brief Flags the time levels of a schedule.
+ *
+ * Like the ex-dividend dates, a time on a level flags that level and a time between two levels is
+ * returned in `between`, to get a stop; times on or after the last level fall on the payoff level.
+ *
+ * @param times Schedule times, between 0 and \( T - T_0 \).
+ * @param between Receives the times that are not on a level.
+ * @return One flag per time level; empty for an empty schedule.
+ */
+std::vector<char> Option::schedule_levels(const std::vector<double>& times, std::vector<double>& between) const {
+    std::vector<char> levels;
+    for (double t : times) {
+        if (!(t >= 0 && t <= T_ - T0_)) throw InvalidSchedule(t);
+        if (levels.empty()) levels.assign(time_mesh_, 0);
+        size_t k;
+        bool on_level = locate_level(t, k);
+        if (k >= time_mesh_ - 1) levels[time_mesh_ - 1] = 1;
+        else if (on_level) levels[k] = 1;
+        else between.push_back(t);
+    }
+    return levels;
+}
+
+/**
+ * @brief Assigns the exercise dates and the barrier monitoring times to the time levels.
+ *
+ * A Bermudan option only needs the exercise value on its exercise levels: between them the
+ * backward sweep takes the European steps of `european_price`, with their cached factorization,
+ * instead of a projected SOR solve per step. Dates between two levels get a stop, as the
+ * ex-dividend dates do.
+ */
+void Option::fill_schedules() {
+    if (!exercise_dates_.empty() && exercise_type_ != 0) throw InvalidSchedule(exercise_type_);
+    std::vector<double> between;
+    exercise_levels_ = schedule_levels(exercise_dates_, between);
+    for (double t : between) {
+        size_t k;
+        locate_level(t, k);
+        stops_[add_stop(t, k)].exercise = true;
+    }
+    between.clear();
+    monitor_levels_ = barrier_.type == BarrierType::None ? std::vector<char>() : schedule_levels(barrier_.monitoring, between);
+    for (double t : between) {
+        size_t k;
+        locate_level(t, k);
+        stops_[add_stop(t, k)].monitor = true;
+    }
+}
+
+/**
+ * @brief Applies the exercise condition \( V \geq \text{payoff} \) to a time level.
+ * @param i Time level, or index of a stop after the last level.
+ */
+void Option::exercise(size_t i) {
+    double* values = level(i);
+    double Sk = S_min_;
+    for (size_t jj = 0; jj <= spot_mesh_; jj++) {
+        values[jj] = std::max(values[jj], std::max(contract_type_ * (Sk - K_), 0.0));
+        Sk += dS;
+    }
+}
+
+/**
+ * @brief Applies a discrete barrier observation to a time level.
+ *
+ * The nodes on the barrier and beyond it are knocked out: they take the rebate or, for the
+ * knock-in claim of `solve_knock_in`, the vanilla values of `knock_values_`.
+ *
+ * @param i Time level, or index of a stop after the last level.
+ */
+void Option::knock_out(size_t i) {
+    bool down = barrier_.type == BarrierType::DownOut || barrier_.type == BarrierType::DownIn;
+    size_t lo = down ? 0 : barrier_node_;
+    size_t hi = down ? barrier_node_ : spot_mesh_;
+    for (size_t jj = lo; jj <= hi; jj++) {
+        node(jj, i) = knock_values_.empty() ? barrier_.rebate : knock_values_[i * (spot_mesh_ + 1) + jj];
+    }
+}
+
+/**
+ * @brief Applies the jump condition of a cash dividend to the interior nodes of a time level.
+ *
+ * Across the ex-dividend time the spot falls by the dividend while the option value is
+ * continuous, so before the dividend \( V(S) = V(S - D) \) with \( V \) the value after it. On the
+ * uniform mesh \( S_j - D \) is node \( j - k - w \) with the same \( k = \lfloor D / \Delta S \rfloor \)
+ * and \( w = D / \Delta S - k \) for every node, so the linear interpolation is a single pass with a
+ * fixed stencil. Nodes whose spot falls below the lowest node take its value: the value at
+ * \( S = 0 \) (the spot cannot become negative) or, on a down barrier, the rebate.
+ *
+ * Values are stored node by node, with `lanes` contiguous values per node.
+ *
+ * @param in Values after the dividend at the nodes 1 to `spot_mesh_ - 1`.
+ * @param low Values after the dividend at the lowest node, one per lane.
+ * @param out Values before the dividend at the same nodes as `in`.
+ * @param lanes Number of values per node.
+ * @param amount Cash dividend.
+ */
+void Option::dividend_jump(const double* in, const double* low, double* out, size_t lanes, double amount) const {
+    size_t n = spot_mesh_ - 1;
+    double shift = amount / dS;
+    size_t k = static_cast<size_t>(std::floor(shift));
+    double w = shift - k;
+
+    // Nodes whose stencil j - k - 1 reaches S = 0 or below.
+    size_t edge = std::min(n, k + 1);
+    for (size_t ii = 0; ii < edge; ii++) {
+        size_t j = ii + 1;
+        for (size_t ll = 0; ll < lanes; ll++) {
+            out[ii * lanes + ll] = j > k ? (1 - w) * in[(j - k - 1) * lanes + ll] + w * low[ll] : low[ll];
+        }
+    }
+
+    size_t a = k * lanes, b = (k + 1) * lanes;
+    for (size_t idx = edge * lanes; idx < n * lanes; idx++) {
+        out[idx] = (1 - w) * in[idx - a] + w * in[idx - b];
+    }
 }
 
 /**
@@ -177,10 +717,12 @@ void Option::create_grid() {
  * @param i Time step index.
  * @return Vector of coefficients \( a_j \).
  */
-std::vector<double> Option::compute_aj(size_t i) {
-    std::vector<double> aj(spot_mesh_ - 2);
+ScratchVector Option::compute_aj(size_t i) {
+    double r = drifts_[i];
+    ScratchVector aj(spot_mesh_ - 2);
     for (size_t jj = 2; jj < spot_mesh_; jj++) {
-        aj[jj - 2] = (dT / 4) * (volatility_ * volatility_ * jj * jj - curve(dT * i) * jj);
+        double x = j0_ + jj;
+        aj[jj - 2] = (dT / 4) * (sigma2(jj, i) * x * x - r * x);
     }
     return aj;
 }
@@ -193,10 +735,12 @@ std::vector<double> Option::compute_aj(size_t i) {
  * @param i Time step index.
  * @return Vector of coefficients \( b_j \).
  */
-std::vector<double> Option::compute_bj(size_t i) {
-    std::vector<double> bj(spot_mesh_ - 1);
+ScratchVector Option::compute_bj(size_t i) {
+    double r = rates_[i];
+    ScratchVector bj(spot_mesh_ - 1);
     for (size_t jj = 1; jj < spot_mesh_; jj++) {
-        bj[jj - 1] = -(dT / 2) * (volatility_ * volatility_ * jj * jj + curve(dT * i));
+        double x = j0_ + jj;
+        bj[jj - 1] = -(dT / 2) * (sigma2(jj, i) * x * x + r);
     }
     return bj;
 }
@@ -209,10 +753,12 @@ std::vector<double> Option::compute_bj(size_t i) {
  * @param i Time step index.
  * @return Vector of coefficients \( c_j \).
  */
-std::vector<double> Option::compute_cj(size_t i) {
-    std::vector<double> cj(spot_mesh_ - 2);
+ScratchVector Option::compute_cj(size_t i) {
+    double r = drifts_[i];
+    ScratchVector cj(spot_mesh_ - 2);
     for (size_t jj = 1; jj < spot_mesh_ - 1; jj++) {
-        cj[jj - 1] = (dT / 4) * (volatility_ * volatility_ * jj * jj + curve(dT * i) * jj);
+        double x = j0_ + jj;
+        cj[jj - 1] = (dT / 4) * (sigma2(jj, i) * x * x + r * x);
     }
     return cj;
 }
@@ -224,15 +770,16 @@ std::vector<double> Option::compute_cj(size_t i) {
  * \[
  * C = \text{Tridiag}(-a, 1 - b, -c)
  * \]
- * where \( a, b, c \) are vectors of coefficients.
+ * where \( a, b, c \) are vectors of coefficients. The coefficient vectors are taken by value
+ * and their storage is reused by the matrix, so passing rvalues allocates nothing.
  *
  * @param a Vector of subdiagonal coefficients \( a_j \).
  * @param b Vector of diagonal coefficients \( b_j \).
  * @param c Vector of superdiagonal coefficients \( c_j \).
  * @return Tridiag object representing the matrix \( C \).
  */
-Tridiag Option::compute_C(std::vector<double> a, std::vector<double> b, std::vector<double> c) {
-    return Tridiag(-1.0 * a, 1.0 - b, -1.0 * c);
+Tridiag Option::compute_C(ScratchVector a, ScratchVector b, ScratchVector c) {
+    return Tridiag(-1.0 * std::move(a), 1.0 - std::move(b), -1.0 * std::move(c));
 }
 
 /**
@@ -242,33 +789,146 @@ Tridiag Option::compute_C(std::vector<double> a, std::vector<double> b, std::vec
  * \[
  * D = \text{Tridiag}(a, 1 + b, c)
  * \]
- * where \( a, b, c \) are vectors of coefficients.
+ * where \( a, b, c \) are vectors of coefficients. The coefficient vectors are taken by value
+ * and their storage is reused by the matrix, so passing rvalues allocates nothing.
  *
  * @param a Vector of subdiagonal coefficients \( a_j \).
  * @param b Vector of diagonal coefficients \( b_j \).
  * @param c Vector of superdiagonal coefficients \( c_j \).
  * @return Tridiag object representing the matrix \( D \).
  */
-Tridiag Option::compute_D(std::vector<double> a, std::vector<double> b, std::vector<double> c) {
-    return Tridiag(a, 1.0 + b, c);
+Tridiag Option::compute_D(ScratchVector a, ScratchVector b, ScratchVector c) {
+    return Tridiag(std::move(a), 1.0 + std::move(b), std::move(c));
+}
+
+/**
+ * @brief Writes the coefficients \( a_j, b_j, c_j \) of a time level into existing vectors.
+ *
+ * Node \( j \) is at \( S = (j_0 + j) \Delta S \), with \( j_0 = 0 \) unless the domain starts above 0
+ * (barrier options). The short rate \( r \) (in \( b_j \)) and the drift \( r - q \) (in \( a_j, c_j \)) are read from the
+ * per-level tables. With a local volatility surface \( \sigma^2 \) is read from the row of the
+ * level in the precomputed table.
+ *
+ * The coefficients scale with the length of the step, \( \Delta T \) except for the sub-steps
+ * that end on a stop.
+ *
+ * @param i Time level, or index of a stop after the last level.
+ * @param h Length of the step.
+ * @param a Subdiagonal coefficients, `spot_mesh_ - 2` values.
+ * @param b Diagonal coefficients, `spot_mesh_ - 1` values.
+ * @param c Superdiagonal coefficients, `spot_mesh_ - 2` values.
+ */
+void Option::fill_coefficients(size_t i, double h, ScratchVector& a, ScratchVector& b, ScratchVector& c) const {
+    double r = rates_[i];
+    double mu = drifts_[i];
+    if (sigma2_.empty()) {
+        for (size_t jj = 1; jj < spot_mesh_; jj++) {
+            double x = j0_ + jj;
+            if (jj > 1) a[jj - 2] = (h / 4) * (volatility_ * volatility_ * x * x - mu * x);
+            b[jj - 1] = -(h / 2) * (volatility_ * volatility_ * x * x + r);
+            if (jj < spot_mesh_ - 1) c[jj - 1] = (h / 4) * (volatility_ * volatility_ * x * x + mu * x);
+        }
+        return;
+    }
+
+    const double* s2 = sigma2_.data() + i * (spot_mesh_ + 1);
+    for (size_t jj = 1; jj < spot_mesh_; jj++) {
+        double x = j0_ + jj;
+        if (jj > 1) a[jj - 2] = (h / 4) * (s2[jj] * x * x - mu * x);
+        b[jj - 1] = -(h / 2) * (s2[jj] * x * x + r);
+        if (jj < spot_mesh_ - 1) c[jj - 1] = (h / 4) * (s2[jj] * x * x + mu * x);
+    }
+}
+
+/**
+ * @brief Tells whether two time levels have the same coefficients.
+ *
+ * Always false with a local volatility surface, whose \( \sigma^2 \) changes with the level.
+ *
+ * @param i First time level.
+ * @param k Second time level.
+ * @return True if the rate and the drift of the two levels are equal and the volatility is flat.
+ */
+bool Option::same_coefficients(size_t i, size_t k) const {
+    return sigma2_.empty() && rates_[i] == rates_[k] && drifts_[i] == drifts_[k];
+}
+
+/**
+ * @brief Overwrites the entries of \( C = \text{Tridiag}(-a, 1 - b, -c) \) without reallocating it.
+ * @param a Vector of subdiagonal coefficients \( a_j \).
+ * @param b Vector of diagonal coefficients \( b_j \).
+ * @param c Vector of superdiagonal coefficients \( c_j \).
+ * @param C Matrix of the right size, updated in place.
+ */
+void Option::assign_C(const ScratchVector& a, const ScratchVector& b, const ScratchVector& c, Tridiag& C) {
+    for (size_t ii = 0; ii < a.size(); ii++) {
+        C.subdiag()[ii] = -1.0 * a[ii];
+        C.superdiag()[ii] = -1.0 * c[ii];
+    }
+    for (size_t ii = 0; ii < b.size(); ii++) {
+        C.diag()[ii] = 1.0 - b[ii];
+    }
+}
+
+/**
+ * @brief Overwrites the entries of \( D = \text{Tridiag}(a, 1 + b, c) \) without reallocating it.
+ * @param a Vector of subdiagonal coefficients \( a_j \).
+ * @param b Vector of diagonal coefficients \( b_j \).
+ * @param c Vector of superdiagonal coefficients \( c_j \).
+ * @param D Matrix of the right size, updated in place.
+ */
+void Option::assign_D(const ScratchVector& a, const ScratchVector& b, const ScratchVector& c, Tridiag& D) {
+    std::copy(a.begin(), a.end(), D.subdiag().begin());
+    std::copy(c.begin(), c.end(), D.superdiag().begin());
+    for (size_t ii = 0; ii < b.size(); ii++) {
+        D.diag()[ii] = 1.0 + b[ii];
+    }
 }
 
 /**
  * @brief Computes the boundary terms \( K_1 \) and \( K_2 \) used for pricing adjustments at the boundaries.
  *
  * These terms represent the contributions of the boundary conditions to the finite difference system.
+ * On the truncated domains of barrier options they are formed from `lower_boundary` and
+ * `upper_boundary`, with the node positions shifted by \( j_0 \).
  *
  * @param i Time step index.
  * @return A pair of boundary terms \( (K_1, K_2) \).
  */
 std::pair<double, double> Option::compute_K(size_t i) {
-    double a1_prec = (dT / 4) * (volatility_ * volatility_ * 1 * 1 - curve(dT * (i - 1)) * 1);
-    double a1_curr = (dT / 4) * (volatility_ * volatility_ * 1 * 1 - curve(dT * i) * 1);
-    double K1 = a1_prec * F0 * std::exp(-curve.integral(dT * (i - 1))) + a1_curr * F0 * std::exp(-curve.integral(dT * i));
+    return step_K(i, i - 1, dT);
+}
 
-    double cm_prec = (dT / 4) * (volatility_ * volatility_ * (spot_mesh_ - 1) * (spot_mesh_ - 1) - curve(dT * (i - 1)) * (spot_mesh_ - 1));
-    double cm_curr = (dT / 4) * (volatility_ * volatility_ * (spot_mesh_ - 1) * (spot_mesh_ - 1) - curve(dT * i) * (spot_mesh_ - 1));
-    double K2 = cm_prec * (FM - K_ * std::exp(-curve.integral(dT * (i - 1)))) + cm_curr * (FM - K_ * std::exp(-curve.integral(dT * i)));
+/**
+ * @brief Computes the boundary terms of a backward step between two instants.
+ *
+ * The terms of `compute_K` for a step of any length: from a time level to the previous one, or
+ * across part of a step split by a stop.
+ *
+ * @param from Time level or stop the step starts from (the later time).
+ * @param to Time level or stop the step ends on (the earlier time).
+ * @param h Length of the step.
+ * @return A pair of boundary terms \( (K_1, K_2) \).
+ */
+std::pair<double, double> Option::step_K(size_t from, size_t to, double h) const {
+    double a1_prec = (h / 4) * (sigma2(1, to) * 1 * 1 - drifts_[to] * 1);
+    double a1_curr = (h / 4) * (sigma2(1, from) * 1 * 1 - drifts_[from] * 1);
+    double K1 = a1_prec * F0 * discounts_[to] + a1_curr * F0 * discounts_[from];
+
+    double cm_prec = (h / 4) * (sigma2(spot_mesh_ - 1, to) * (spot_mesh_ - 1) * (spot_mesh_ - 1) - drifts_[to] * (spot_mesh_ - 1));
+    double cm_curr = (h / 4) * (sigma2(spot_mesh_ - 1, from) * (spot_mesh_ - 1) * (spot_mesh_ - 1) - drifts_[from] * (spot_mesh_ - 1));
+    double K2 = cm_prec * (FM * carries_[to] - K_ * discounts_[to]) + cm_curr * (FM * carries_[from] - K_ * discounts_[from]);
+
+    if (!vanilla_domain()) {
+        double x1 = j0_ + 1, xm = j0_ + spot_mesh_ - 1;
+        a1_prec = (h / 4) * (sigma2(1, to) * x1 * x1 - drifts_[to] * x1);
+        a1_curr = (h / 4) * (sigma2(1, from) * x1 * x1 - drifts_[from] * x1);
+        K1 = a1_prec * lower_boundary(to) + a1_curr * lower_boundary(from);
+
+        double c_prec = (h / 4) * (sigma2(spot_mesh_ - 1, to) * xm * xm + drifts_[to] * xm);
+        double c_curr = (h / 4) * (sigma2(spot_mesh_ - 1, from) * xm * xm + drifts_[from] * xm);
+        K2 = c_prec * upper_boundary(to) + c_curr * upper_boundary(from);
+    }
 
     return std::make_pair(K1, K2);
 }
@@ -281,31 +941,116 @@ std::pair<double, double> Option::compute_K(size_t i) {
  * - Computes the right-hand side (RHS) of the linear system using \( D \) and boundary terms \( K \).
  * - Solves the linear system \( C \cdot F = \text{RHS} \) to update the option values.
  * - Applies boundary conditions for the grid values at each step.
+ *
+ * The grid is stored by time level, so each level is a contiguous slice. Below the partitioned
+ * solver threshold (see `Tridiag::solver`) a step is a single fused kernel, `Tridiag::solve_product`,
+ * which reads the interior of level \( j \) and writes the interior of level \( j - 1 \) in place;
+ * larger meshes build the RHS in a buffer and use the partitioned solver.
+ *
+ * Each time level's coefficients are computed once: those of level \( j - 1 \), used by \( C \),
+ * are kept for \( D \) at the next step. The matrices are allocated once and only refilled when
+ * the rate or the drift of their level changes, so on flat segments of the curves a step does no
+ * coefficient work at all. With a local volatility surface the coefficients change with every
+ * level and are refilled at each step from the row of the \( \sigma^2 \) table.
+ *
+ * On the time level of an ex-dividend date the solved values are replaced by their jump
+ * condition (see `dividend_jump`) before the next step. The exercise value of a Bermudan option
+ * and the observations of a discrete barrier are then applied on their scheduled levels only.
+ * A step across a stop, an event between two levels, is split in sub-steps of
+ * \( h < \Delta T \) ending on each stop, where the event is applied in the same way; the matrices
+ * of the sub-steps are rebuilt for their length, and the caching resumes on the next full step.
+ *
+ * @param start Time level the backward sweep starts from; levels from `start` on must be filled.
  */
-void Option::european_price() {
-    Tridiag C, D;
-    std::pair<double, double> K;
-    std::vector<double> a_c, b_c, c_c, a_d, b_d, c_d, RHS;
-    size_t zz;
+void Option::european_price(size_t start) {
+    size_t n = spot_mesh_ - 1;
+    bool fused = Tridiag::solver(n) == TridiagSolver::Thomas;
+    ScratchVector F(fused ? 0 : n), RHS(fused ? 0 : n), jump(jumps_.empty() && stops_.empty() ? 0 : n);
 
-    for (size_t jj = time_mesh_ - 1; jj > 0; jj--) {
-        a_c = compute_aj(jj - 1), a_d = compute_aj(jj);
-        b_c = compute_bj(jj - 1), b_d = compute_bj(jj);
-        c_c = compute_cj(jj - 1), c_d = compute_cj(jj);
+    ScratchVector a(n - 1), b(n), c(n - 1);
+    Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    Tridiag D(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    const size_t NONE = std::numeric_limits<size_t>::max();
+    size_t level_C = NONE, level_D = NONE;
+    fill_coefficients(start, dT, a, b, c);
 
-        C = compute_C(a_c, b_c, c_c);
-        D = compute_D(a_d, b_d, c_d);
-        K = compute_K(jj);
+    // Solves C x = D f + K, f being the values of `from` and x those of `to`.
+    auto advance = [&](size_t from, size_t to, std::pair<double, double> K) {
+        double* prev = level(from) + 1;
+        double* curr = level(to) + 1;
+        ArenaScope step;
 
-        RHS = D * F + K;
+        if (fused) {
+            C.solve_product(D, prev, K, curr);
+        }
+        else {
+            std::copy(prev, prev + n, F.begin());
+            D.multiply(F, RHS);
+            RHS.front() += K.first;
+            RHS.back() += K.second;
 
-        F = C.solve(RHS);
+            RHS = C.solve(std::move(RHS), TridiagSolver::Partitioned);
+            std::copy(RHS.begin(), RHS.end(), curr);
+        }
+    };
 
-        grid[0][jj - 1] = F0 * std::exp(-curve.integral(dT * (jj - 1)));
-        for (zz = 1; zz < spot_mesh_; zz++) {
-            grid[zz][jj - 1] = F[zz - 1];
+    // Boundary values and events of a time level or a stop.
+    auto settle = [&](size_t i) {
+        if (vanilla_domain()) {
+            node(0, i) = F0 * discounts_[i];
+            node(spot_mesh_, i) = (FM * carries_[i] - K_ * discounts_[i]) * (contract_type_ == 1);
         }
-        grid[zz][jj - 1] = (FM - K_ * std::exp(-curve.integral(dT * (jj - 1)))) * (contract_type_ == 1);
+        else {
+            node(0, i) = lower_boundary(i);
+            node(spot_mesh_, i) = upper_boundary(i);
+        }
+
+        double dividend = dividend_at(i);
+        if (dividend > 0) {
+            double* values = level(i);
+            dividend_jump(values + 1, values, jump.data(), 1, dividend);
+            std::copy(jump.begin(), jump.end(), values + 1);
+        }
+        if (exercise_at(i)) exercise(i);
+        if (monitor_at(i)) knock_out(i);
+    };
+
+    for (size_t jj = start; jj > 0; jj--) {
+        std::pair<size_t, size_t> split = stop_range(jj - 1);
+        if (split.first == split.second) {
+            // a, b, c hold the coefficients of level jj.
+            if (level_D == NONE || !same_coefficients(level_D, jj)) {
+                assign_D(a, b, c, D);
+                level_D = jj;
+            }
+            if (!same_coefficients(jj, jj - 1)) {
+                fill_coefficients(jj - 1, dT, a, b, c);
+            }
+            if (level_C == NONE || !same_coefficients(level_C, jj - 1)) {
+                assign_C(a, b, c, C);
+                level_C = jj - 1;
+            }
+            advance(jj, jj - 1, compute_K(jj));
+        }
+        else {
+            // Sub-steps from level jj to each stop, latest first, then to level jj - 1.
+            size_t from = jj;
+            for (size_t ss = split.second; ss >= split.first; ss--) {
+                size_t to = ss > split.first ? time_mesh_ + ss - 1 : jj - 1;
+                double h = time_at(from) - time_at(to);
+                fill_coefficients(from, h, a, b, c);
+                assign_D(a, b, c, D);
+                fill_coefficients(to, h, a, b, c);
+                assign_C(a, b, c, C);
+                advance(from, to, step_K(from, to, h));
+                if (to == jj - 1) break;
+                settle(to);
+                from = to;
+            }
+            fill_coefficients(jj - 1, dT, a, b, c);
+            level_C = level_D = NONE;
+        }
+        settle(jj - 1);
     }
 }
 
@@ -313,85 +1058,259 @@ void Option::european_price() {
  * @brief Computes the price of an American option using the finite difference method with a penalty approach.
  *
  * This method uses an iterative process to enforce the early exercise condition:
- * - Constructs the tridiagonal matrix \( D \) and computes the RHS.
- * - Iteratively solves the system with a penalty term to ensure the option value respects the exercise condition.
- * - Updates the option value grid by taking the maximum of the intrinsic value and the continuation value.
+ * - Constructs the tridiagonal matrices \( C \) and \( D \) and computes the RHS.
+ * - Solves \( C \cdot F = \text{RHS} \) with projected SOR, starting from the values of the previous step,
+ *   so that the option value never falls below the intrinsic value.
  * - Applies boundary conditions at each time step.
+ *
+ * The sweep ordering (sequential Gauss-Seidel or parallel red-black) and the relaxation parameter
+ * are chosen by `ProjectedSOR` from the settings and the mesh. With `PSORSettings::extrapolate` each
+ * step starts from the linear extrapolation in time \( \max(g, 2F^{n+1} - F^{n+2}) \) instead of \( F^{n+1} \).
+ *
+ * The matrices, the RHS, the previous level and the intrinsic values are allocated once per pricing;
+ * with a flat volatility the matrices are only refilled when the rate or the drift changes from
+ * one level to the next.
+ *
+ * On the time level of an ex-dividend date the jump condition is applied to the solved values and
+ * the exercise value is enforced again, since the holder may exercise just before the dividend;
+ * the extrapolation of the initial guess restarts after the jump. The observations of a discretely
+ * monitored barrier are applied the same way, on their levels only. A step across a stop is split
+ * in sub-steps ending on each stop, as in `european_price`, each with its own projected SOR solve;
+ * the step reports their summed sweeps.
+ *
+ * The statistics of every solve are kept in `psor_convergence()`; the steps that hit the sweep cap
+ * or diverged are also recorded in `warnings()`, and the pricing goes on with the solver's iterate
+ * (the last one after the sweep cap, the one with the smallest residual after a divergence).
+ *
+ * @param F Option values at the interior nodes of level `start`, updated in place.
+ * @param start Time level the backward sweep starts from; levels from `start` on must be filled.
  */
-void Option::american_price() {
-    std::vector<double> a, b, c;
-    Tridiag D;
-    std::pair<double, double> K;
-    double Sk;
-    std::vector<double> RHS;
-    size_t ii, zz;
-
-    for (size_t jj = time_mesh_ - 1; jj > 0; jj--) {
-        a = compute_aj(jj);
-        b = compute_bj(jj);
-        c = compute_cj(jj);
-
-        D = compute_D(a, b, c);
-        K = compute_K(jj);
-
-        RHS = D * F + K;
-
-        double error = 1e6;
-        std::vector<double> F_tmp(spot_mesh_ - 1);
-
-        while (error > tol_) {
-            Sk = dS;
-            F_tmp[0] = std::max(std::max(contract_type_ * (Sk - K_), 0.0),
-                F[0] + (w_ / (1 - b[0])) * (RHS[0] - (1 - b[0]) * F[0] + c[0] * F[1]));
-
-            ii = 1;
-            for (; ii < spot_mesh_ - 2; ii++) {
-                Sk += dS;
-                F_tmp[ii] = std::max(std::max(contract_type_ * (Sk - K_), 0.0),
-                    F[ii] + (w_ / (1 - b[ii])) * (RHS[ii] + a[ii - 1] * F_tmp[ii - 1] -
-                        (1 - b[ii]) * F[ii] + c[ii] * F[ii + 1]));
+void Option::american_price(ScratchVector& F, size_t start) {
+    double Sk = S_min_;
+    ScratchVector RHS(F.size());
+    ScratchVector payoff(F.size());
+    ScratchVector F_prev(psor_.extrapolate ? F.size() : 0);
+    ScratchVector jump(jumps_.empty() && stops_.empty() ? 0 : F.size());
+    bool has_prev = false;
+    ProjectedSOR psor(psor_);
+    size_t n = F.size();
+    ScratchVector a(n - 1), b(n), c(n - 1);
+    Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    Tridiag D(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+    const size_t NONE = std::numeric_limits<size_t>::max();
+    size_t level_CD = NONE;
+    size_t zz;
+
+    for (zz = 0; zz < payoff.size(); zz++) {
+        Sk += dS;
+        payoff[zz] = std::max(contract_type_ * (Sk - K_), 0.0);
+    }
+
+    psor_sweeps_ = 0;
+    psor_steps_.assign(time_mesh_ - 1, PSORStats());
+    warnings_.clear();
+
+    // Solves the complementarity problem of a step from the values in F; C and D are filled.
+    auto advance = [&](std::pair<double, double> K) {
+        ArenaScope step;
+
+        D.multiply(F, RHS);
+        RHS.front() += K.first;
+        RHS.back() += K.second;
+
+        if (psor_.extrapolate) {
+            if (!has_prev) {
+                std::copy(F.begin(), F.end(), F_prev.begin());
+                has_prev = true;
+            }
+            else {
+                for (zz = 0; zz < F.size(); zz++) {
+                    double guess = 2 * F[zz] - F_prev[zz];
+                    F_prev[zz] = F[zz];
+                    F[zz] = std::max(payoff[zz], guess);
+                }
             }
+        }
 
-            Sk += dS;
-            F_tmp[ii] = std::max(std::max(contract_type_ * (Sk - K_), 0.0),
-                F[ii] + (w_ / (1 - b[ii])) * (RHS[ii] + a[ii - 1] * F_tmp[ii - 1] - (1 - b[ii]) * F[ii]));
+        PSORStats stats = psor.solve(C, RHS, payoff, F);
+        psor_sweeps_ += stats.sweeps;
+        return stats;
+    };
 
-            error = norm(F - F_tmp);
-            F = F_tmp;
+    // Boundary values and events of a time level or a stop; F holds its interior values.
+    auto settle = [&](size_t i) {
+        double* curr = level(i);
+        curr[0] = vanilla_domain() ? F0 : lower_boundary(i);
+        double dividend = dividend_at(i);
+        if (dividend > 0) {
+            dividend_jump(F.data(), curr, jump.data(), 1, dividend);
+            for (zz = 0; zz < F.size(); zz++) {
+                F[zz] = std::max(payoff[zz], jump[zz]);
+            }
+            has_prev = false;
         }
+        std::copy(F.begin(), F.end(), curr + 1);
+        curr[spot_mesh_] = vanilla_domain() ? (FM - K_) * (contract_type_ == 1) : upper_boundary(i);
+        if (monitor_at(i)) {
+            knock_out(i);
+            std::copy(curr + 1, curr + spot_mesh_, F.begin());
+            has_prev = false;
+        }
+    };
 
-        grid[0][jj - 1] = F0;
-        for (zz = 1; zz < spot_mesh_; zz++) {
-            grid[zz][jj - 1] = F[zz - 1];
+    for (size_t jj = start; jj > 0; jj--) {
+        std::pair<size_t, size_t> split = stop_range(jj - 1);
+        PSORStats stats;
+        if (split.first == split.second) {
+            if (level_CD == NONE || !same_coefficients(level_CD, jj)) {
+                fill_coefficients(jj, dT, a, b, c);
+                assign_D(a, b, c, D);
+                assign_C(a, b, c, C);
+                level_CD = jj;
+            }
+            stats = advance(compute_K(jj));
+        }
+        else {
+            // Sub-steps from level jj to each stop, latest first, then to level jj - 1; the
+            // extrapolation of the initial guess assumes equal steps and restarts on each one.
+            // The step keeps the statistics of a sub-step that failed, else of the last one.
+            size_t from = jj, sweeps = 0;
+            PSORStats failed;
+            for (size_t ss = split.second; ss >= split.first; ss--) {
+                size_t to = ss > split.first ? time_mesh_ + ss - 1 : jj - 1;
+                double h = time_at(from) - time_at(to);
+                fill_coefficients(from, h, a, b, c);
+                assign_D(a, b, c, D);
+                assign_C(a, b, c, C);
+                has_prev = false;
+                stats = advance(step_K(from, to, h));
+                sweeps += stats.sweeps;
+                if (stats.status != PSORStatus::Converged) failed = stats;
+                if (to == jj - 1) break;
+                settle(to);
+                from = to;
+            }
+            if (failed.status != PSORStatus::Converged) stats = failed;
+            stats.sweeps = sweeps;
+            has_prev = false;
+            level_CD = NONE;
         }
-        grid[zz][jj - 1] = (FM - K_) * (contract_type_ == 1);
+
+        psor_steps_[jj - 1] = stats;
+        if (stats.status != PSORStatus::Converged) {
+            std::ostringstream msg;
+            msg << "PSOR " << (stats.status == PSORStatus::Diverged ? "diverged, also after the restart with w = 1," : "reached the sweep cap")
+                << " at t = " << T0_ + dT * (jj - 1) << ": " << stats.sweeps << " sweeps, update norm " << stats.error
+                << " (tolerance " << psor_.tol << ")";
+            warnings_.push_back({ jj - 1, T0_ + dT * (jj - 1), stats, msg.str() });
+        }
+        settle(jj - 1);
+    }
+}
+
+/**
+ * @brief Builds the same option with some inputs changed.
+ *
+ * The copy keeps the kind of volatility of the option: the flat volatility or the local
+ * volatility surface is shifted by `vol_shift`.
+ *
+ * @param spot_mesh Number of spot steps in the grid.
+ * @param S_max Upper bound of the spot grid.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param vol_shift Absolute shift of the volatility.
+ * @param psor Settings of the projected SOR solver.
+ * @return Option priced with the new inputs.
+ */
+Option Option::variant(unsigned int spot_mesh, double S_max, InterestRateHandle rate_curve, double vol_shift, const PSORSettings& psor) const {
+    if (local_vol_) {
+        LocalVolHandle surface = vol_shift == 0 ? local_vol_ : local_vol_->shifted(vol_shift);
+        return Option(contract_type_, exercise_type_, T_, K_, T0_, time_mesh_, spot_mesh, S0_, std::move(rate_curve), std::move(surface), psor, S_max, dividends_, dividend_yield_, repo_, barrier_, exercise_dates_);
     }
+    return Option(contract_type_, exercise_type_, T_, K_, T0_, time_mesh_, spot_mesh, S0_, std::move(rate_curve), volatility_ + vol_shift, psor, S_max, dividends_, dividend_yield_, repo_, barrier_, exercise_dates_);
+}
+
+/**
+ * @brief Changes the contract type and the strike, with the boundary values of the vanilla domain.
+ * @param contract_type 1 for Call, -1 for Put.
+ * @param K Strike price.
+ */
+void Option::set_contract(int contract_type, double K) {
+    contract_type_ = contract_type;
+    K_ = K;
+    if (contract_type_ == 1) { F0 = 0, FM = S_max_; }
+    else { F0 = K_, FM = 0; }
+}
+
+/**
+ * @brief Builds the option of a scenario on the same mesh, without pricing it.
+ *
+ * The copy takes the contract type, the strike and the volatility of the scenario; a local
+ * volatility surface is scaled so that \( \sigma(S_0, 0) \) becomes the volatility of the scenario,
+ * which keeps every node positive. The grid is copied as it is, so `price_scenarios` calls this
+ * on a prototype whose grid was released, and the copy creates its own grid before a `solve`.
+ *
+ * @param sc Contract type, strike and volatility of the scenario.
+ * @return Option of the scenario, with its statistics reset.
+ */
+Option Option::scenario(const Scenario& sc) const {
+    Option tmp(*this);
+    tmp.set_contract(sc.contract_type, sc.K);
+    if (local_vol_ && sc.volatility != volatility_) {
+        tmp.local_vol_ = local_vol_->scaled(sc.volatility / volatility_);
+        tmp.fill_local_vol();
+    }
+    tmp.volatility_ = sc.volatility;
+    tmp.psor_sweeps_ = 0;
+    tmp.psor_steps_.clear();
+    tmp.warnings_.clear();
+    return tmp;
 }
 
 /**
  * @brief Solves the option pricing problem.
  *
- * Initializes and fills the pricing grid using either the `european_price` or `american_price` method.
+ * Initializes and fills the pricing grid using either the `european_price` or `american_price` method;
+ * knock-in options are priced by `solve_knock_in`.
+ * All scratch vectors are drawn from the thread-local arena, which is reset when the solve returns;
+ * only the grid is kept.
  */
 void Option::solve() {
-    double Sk = 0;
-    size_t ii = 0;
+    if (barrier_.type == BarrierType::UpIn || barrier_.type == BarrierType::DownIn) {
+        solve_knock_in();
+        return;
+    }
 
-    F.resize(spot_mesh_ - 1);
+    ArenaScope pricing;
+    double Sk = S_min_;
+    double* last = level(time_mesh_ - 1);
 
-    for (; ii <= spot_mesh_; ii++) {
-        grid[ii][time_mesh_ - 1] = std::max(contract_type_ * (Sk - K_), 0.0);
-        if (ii != 0 && ii != spot_mesh_) {
-            F[ii - 1] = grid[ii][time_mesh_ - 1];
-        }
+    for (size_t ii = 0; ii <= spot_mesh_; ii++) {
+        last[ii] = zero_payoff_ ? 0.0 : std::max(contract_type_ * (Sk - K_), 0.0);
         Sk += dS;
     }
+    if (barrier_.type == BarrierType::DownOut) last[0] = lower_boundary(time_mesh_ - 1);
+    if (barrier_.type == BarrierType::UpOut) last[spot_mesh_] = upper_boundary(time_mesh_ - 1);
+    if (!monitor_levels_.empty() && monitor_levels_[time_mesh_ - 1]) knock_out(time_mesh_ - 1);
+
+    solve_from(time_mesh_ - 1);
+}
 
-    if (exercise_type_) {
-        european_price();
+/**
+ * @brief Runs the backward sweep from a given time level down to the first one.
+ *
+ * Levels from `start` to the last one are taken as they are in the grid, which lets a pricing
+ * restart from the part of another grid that does not depend on a changed input. European and
+ * Bermudan options take the European steps, American options the projected SOR ones.
+ *
+ * @param start First time level of the sweep.
+ */
+void Option::solve_from(size_t start) {
+    if (exercise_type_ || !exercise_levels_.empty()) {
+        european_price(start);
     }
     else {
-        american_price();
+        ScratchVector F(level(start) + 1, level(start) + spot_mesh_);
+        american_price(F, start);
     }
 }
 
@@ -404,7 +1323,7 @@ void Option::solve() {
  * @return The computed option price at \( S_0 \) and \( T_0 \).
  */
 double Option::price() {
-    return grid[std::round(S0_ / dS)][0];
+    return node(spot_node(S0_), 0);
 }
 
 /**
@@ -417,7 +1336,7 @@ void Option::display_grid() {
     std::cout << std::fixed << std::setprecision(3);
     for (size_t ii = 0; ii <= spot_mesh_; ii++) {
         for (size_t jj = 0; jj < time_mesh_; jj++) {
-            std::cout << std::setw(7) << grid[ii][jj] << " ";
+            std::cout << std::setw(7) << node(ii, jj) << " ";
         }
         std::cout << '\n';
     }
@@ -437,8 +1356,8 @@ void Option::display_grid() {
  */
 double Option::delta(double S) {
 
-    double d1 = grid[std::round(S / dS) + 1][0];
-    double d2 = grid[std::round(S / dS) - 1][0];
+    double d1 = node(spot_node(S) + 1, 0);
+    double d2 = node(spot_node(S) - 1, 0);
 
     return (d1 - d2) / (2*dS);
 }
@@ -456,9 +1375,9 @@ double Option::delta(double S) {
  * @return The computed Gamma value.
  */
 double Option::gamma() {
-    double g1 = grid[std::round(S0_ / dS) + 1][0];
-    double g2 = grid[std::round(S0_ / dS) - 1][0];
-    double g3 = grid[std::round(S0_ / dS)][0];
+    double g1 = node(spot_node(S0_) + 1, 0);
+    double g2 = node(spot_node(S0_) - 1, 0);
+    double g3 = node(spot_node(S0_), 0);
 
     return (g1 + g2 - 2 * g3) / dS / dS;
 }
@@ -475,8 +1394,8 @@ double Option::gamma() {
  * @return The computed Theta value.
  */
 double Option::theta() {
-    double t1 = grid[std::round(S0_ / dS)][1];
-    double t2 = grid[std::round(S0_ / dS)][0];
+    double t1 = node(spot_node(S0_), 1);
+    double t2 = node(spot_node(S0_), 0);
 
     return (t1 - t2) / (dT);
 }
@@ -491,12 +1410,15 @@ double Option::theta() {
  * \nu = \frac{\text{price}(\sigma + \Delta \sigma) - \text{price}(\sigma)}{\Delta \sigma}
  * \]
  *
+ * With a local volatility surface the whole surface is shifted by \( \Delta \sigma \), with
+ * \( \sigma = \sigma(S_0, 0) \).
+ *
  * @param h Proportional increment for the volatility (\( \Delta \sigma = \sigma \cdot h \)).
  * @return The computed Vega value.
  */
 double Option::vega(double h) {
     double shift = volatility_ * h;
-    Option tmp(contract_type_, exercise_type_, T_, K_, T0_, time_mesh_, spot_mesh_, S0_, interest_rate_, volatility_ + shift);
+    Option tmp = variant(mesh_input_, S_max_input_, curve, shift, psor_);
 
     return (tmp.price() - price()) / shift;
 }
@@ -511,16 +1433,530 @@ double Option::vega(double h) {
  * \rho = \frac{\text{price}(r + \Delta r) - \text{price}(r)}{\Delta r}
  * \]
  *
- * @param h Proportional increment for the interest rate (\( \Delta r = h \cdot r \)).
+ * The whole curve is shifted by \( \Delta r = h \cdot r_0 \), with \( r_0 \) the rate of its first point.
+ * A curve whose first rate is 0 would not move: it is shifted by the absolute amount \( \Delta r = h \).
+ *
+ * @param h Proportional increment for the interest rate (\( \Delta r = h \cdot r_0 \)), or absolute
+ * increment if \( r_0 = 0 \).
  * @return The computed Rho value.
  */
 double Option::rho(double h) {
-    std::vector<std::pair<double, double>> ir_tmp = interest_rate_;
-    double shift = h * ir_tmp[0].second;
+    std::vector<std::pair<double, double>> ir_tmp = curve->points();
+    double shift = ir_tmp[0].second == 0 ? h : h * ir_tmp[0].second;
     for (std::pair<double, double>& elem : ir_tmp) {
         elem.second += shift;
     }
-    Option tmp(contract_type_, exercise_type_, T_, K_, T0_, time_mesh_, spot_mesh_, S0_, ir_tmp, volatility_);
+    Option tmp = variant(mesh_input_, S_max_input_, std::make_shared<const InterestRate>(std::move(ir_tmp)), 0, psor_);
 
     return (tmp.price() - price()) / shift;
+}
+
+/**
+ * @brief Runs the backward sweep of European or Bermudan lanes advanced in lock step.
+ *
+ * The lanes are scenarios of this option with their own contract type, strike and volatility. Their
+ * values are stored node by node, the lanes of a spot node being contiguous, so that every loop over
+ * the nodes has an inner loop over the lanes that the compiler vectorizes; the lanes are split in
+ * tiles across `ThreadPool::global()`.
+ *
+ * The lanes share the mesh, the curve tables, the dividend jumps, the exercise levels and the
+ * stops of `european_price`, across which every lane takes the same sub-steps, and the
+ * boundary values of their contract. Each lane keeps its own coefficients \( a_j, b_j, c_j \) of the
+ * two levels of a step: those of a volatility are filled by `fill_coefficients` when the rate, the
+ * drift or a local volatility changes from one level to the next, as in `european_price`, and copied
+ * to each of its lanes. Under a local volatility surface each volatility has the \( \sigma^2 \) table
+ * of the surface scaled by `scenario`.
+ *
+ * A step runs `Tridiag::solve_product` on every lane, operation for operation: the product by
+ * \( D \), the factorization of \( C \) and the elimination are fused in one pass over the nodes,
+ * and the pivot recurrences of the lanes, which are independent, run side by side in the vector
+ * units. Each lane thus gets the grid values of the scenario priced alone whenever its `solve`
+ * uses the Thomas recurrence.
+ *
+ * @param scenarios Contract type, strike and volatility of the lanes.
+ * @param lanes Indices in `scenarios` of the lanes.
+ * @param prices Receives the price at \( S_0 \) and \( T_0 \) of each lane, at its index in `scenarios`.
+ */
+void Option::sweep_lanes(const std::vector<Scenario>& scenarios, const std::vector<size_t>& lanes, double* prices) {
+    const size_t TILE = 32;
+    ArenaScope pricing;
+    size_t n = spot_mesh_ - 1;
+    bool bermudan = !exercise_levels_.empty();
+
+    // Lanes ordered by volatility: the lanes of volatility v are [first[v], first[v + 1]).
+    std::vector<double> vols;
+    std::vector<size_t> order;
+    std::vector<size_t> first(1, 0);
+    for (size_t ll = 0; ll < lanes.size(); ll++) {
+        double vol = scenarios[lanes[ll]].volatility;
+        if (std::find(vols.begin(), vols.end(), vol) != vols.end()) continue;
+        vols.push_back(vol);
+        for (size_t kk = ll; kk < lanes.size(); kk++) {
+            if (scenarios[lanes[kk]].volatility == vol) order.push_back(lanes[kk]);
+        }
+        first.push_back(order.size());
+    }
+    size_t L = order.size();
+    size_t V = vols.size();
+
+    // Volatility v is given to the option by swapping it in, and taken back by the same swap.
+    std::vector<std::vector<double>> tables(V);
+    std::vector<double> times;
+    for (const Stop& stop : stops_) {
+        times.push_back(stop.time);
+    }
+    for (size_t vv = 0; vv < V && local_vol_; vv++) {
+        tables[vv] = vols[vv] == volatility_ ? sigma2_ : local_vol_->scaled(vols[vv] / volatility_)->variance_table(S_min_, dS, spot_mesh_ + 1, dT, time_mesh_, times);
+    }
+    auto swap_volatility = [&](size_t vv) {
+        std::swap(volatility_, vols[vv]);
+        sigma2_.swap(tables[vv]);
+    };
+
+    ScratchVector F(n * L), X(n * L), payoff(bermudan ? n * L : 0), piv(n * L);
+    ScratchVector K1(L), K2(L), lo(L);
+    bool jumps = !jumps_.empty() || !stops_.empty();
+    ScratchVector jump(jumps ? n * L : 0), low(jumps ? L : 0);
+
+    for (size_t ll = 0; ll < L; ll++) {
+        const Scenario& sc = scenarios[order[ll]];
+        set_contract(sc.contract_type, sc.K);
+        lo[ll] = F0;
+        double Sk = S_min_;
+        for (size_t ii = 0; ii < n; ii++) {
+            Sk += dS;
+            double g = std::max(sc.contract_type * (Sk - sc.K), 0.0);
+            if (bermudan) payoff[ii * L + ll] = g;
+            F[ii * L + ll] = g;
+        }
+    }
+
+    // Coefficients a, b, c of two time levels for every lane, row ii of lane ll at ii * L + ll.
+    ScratchVector coefficients[2][3] = {
+        { ScratchVector(n * L), ScratchVector(n * L), ScratchVector(n * L) },
+        { ScratchVector(n * L), ScratchVector(n * L), ScratchVector(n * L) } };
+    ScratchVector a(n - 1), b(n), c(n - 1);
+    auto fill_lanes = [&](size_t i, double h, ScratchVector* abc) {
+        for (size_t vv = 0; vv < V; vv++) {
+            swap_volatility(vv);
+            fill_coefficients(i, h, a, b, c);
+            swap_volatility(vv);
+            for (size_t ll = first[vv]; ll < first[vv + 1]; ll++) {
+                double* pa = abc[0].data() + ll;
+                double* pb = abc[1].data() + ll;
+                double* pc = abc[2].data() + ll;
+                for (size_t ii = 0; ii + 1 < n; ii++) {
+                    pa[ii * L] = a[ii];
+                    pb[ii * L] = b[ii];
+                    pc[ii * L] = c[ii];
+                }
+                pb[(n - 1) * L] = b[n - 1];
+            }
+        }
+    };
+
+    // Boundary terms of every lane for the step from `from` to `to`.
+    auto fill_K = [&](size_t from, size_t to, double h) {
+        for (size_t vv = 0; vv < V; vv++) {
+            swap_volatility(vv);
+            for (size_t ll = first[vv]; ll < first[vv + 1]; ll++) {
+                const Scenario& sc = scenarios[order[ll]];
+                set_contract(sc.contract_type, sc.K);
+                std::pair<double, double> K = step_K(from, to, h);
+                K1[ll] = K.first;
+                K2[ll] = K.second;
+            }
+            swap_volatility(vv);
+        }
+    };
+
+    // Each lane runs Tridiag::solve_product on its own D = Tridiag(a, 1 + b, c) and C = Tridiag(-a, 1 - b, -c).
+    size_t tiles = (L + TILE - 1) / TILE;
+    auto advance = [&](size_t level_D, size_t level_C) {
+        const double* Da = coefficients[level_D][0].data();
+        const double* Db = coefficients[level_D][1].data();
+        const double* Dc = coefficients[level_D][2].data();
+        const double* Ca = coefficients[level_C][0].data();
+        const double* Cb = coefficients[level_C][1].data();
+        const double* Cc = coefficients[level_C][2].data();
+        ThreadPool::global().parallel_for(0, tiles, [&](size_t lo_tile, size_t hi_tile) {
+            for (size_t tt = lo_tile; tt < hi_tile; tt++) {
+                size_t begin = tt * TILE, end = std::min(L, begin + TILE);
+                const double* f = F.data();
+                double* x = X.data();
+                double* v = piv.data();
+                for (size_t ll = begin; ll < end; ll++) {
+                    v[ll] = 1.0 - Cb[ll];
+                    x[ll] = ((1.0 + Db[ll]) * f[ll] + Dc[ll] * f[ll + L]) + K1[ll];
+                }
+                for (size_t ii = 1; ii + 1 < n; ii++) {
+                    size_t row = ii * L;
+                    for (size_t ll = begin; ll < end; ll++) {
+                        size_t kk = row + ll;
+                        double l = (-1.0 * Ca[kk - L]) / v[kk - L];
+                        v[kk] = (1.0 - Cb[kk]) - l * (-1.0 * Cc[kk - L]);
+                        x[kk] = (Da[kk - L] * f[kk - L] + (1.0 + Db[kk]) * f[kk] + Dc[kk] * f[kk + L]) - l * x[kk - L];
+                    }
+                }
+                size_t row = (n - 1) * L;
+                for (size_t ll = begin; ll < end; ll++) {
+                    size_t kk = row + ll;
+                    double l = (-1.0 * Ca[kk - L]) / v[kk - L];
+                    v[kk] = (1.0 - Cb[kk]) - l * (-1.0 * Cc[kk - L]);
+                    x[kk] = ((Da[kk - L] * f[kk - L] + (1.0 + Db[kk]) * f[kk]) + K2[ll]) - l * x[kk - L];
+                    x[kk] = x[kk] / v[kk];
+                }
+                for (size_t ii = n - 1; ii > 0; ii--) {
+                    size_t up = (ii - 1) * L;
+                    for (size_t ll = begin; ll < end; ll++) {
+                        size_t kk = up + ll;
+                        x[kk] = (x[kk] - (-1.0 * Cc[kk]) * x[kk + L]) / v[kk];
+                    }
+                }
+            }
+        });
+        F.swap(X);
+    };
+
+    // Dividend and exercise of a time level or a stop.
+    auto settle = [&](size_t i) {
+        double dividend = dividend_at(i);
+        if (dividend > 0) {
+            for (size_t ll = 0; ll < L; ll++) {
+                low[ll] = lo[ll] * discounts_[i];
+            }
+            dividend_jump(F.data(), low.data(), jump.data(), L, dividend);
+            std::copy(jump.begin(), jump.end(), F.begin());
+        }
+        if (bermudan && exercise_at(i)) {
+            for (size_t kk = 0; kk < n * L; kk++) {
+                F[kk] = std::max(payoff[kk], F[kk]);
+            }
+        }
+    };
+
+    size_t start = time_mesh_ - 1;
+    size_t level_D = 0;
+    fill_lanes(start, dT, coefficients[level_D]);
+
+    for (size_t jj = start; jj > 0; jj--) {
+        std::pair<size_t, size_t> split = stop_range(jj - 1);
+        if (split.first == split.second) {
+            // D is built from the coefficients of level jj, C from those of level jj - 1.
+            size_t level_C = level_D;
+            if (!same_coefficients(jj, jj - 1)) {
+                level_C = 1 - level_D;
+                fill_lanes(jj - 1, dT, coefficients[level_C]);
+            }
+            fill_K(jj, jj - 1, dT);
+            advance(level_D, level_C);
+            level_D = level_C;
+        }
+        else {
+            // Sub-steps from level jj to each stop, latest first, then to level jj - 1.
+            size_t from = jj;
+            for (size_t ss = split.second; ss >= split.first; ss--) {
+                size_t to = ss > split.first ? time_mesh_ + ss - 1 : jj - 1;
+                double h = time_at(from) - time_at(to);
+                fill_lanes(from, h, coefficients[0]);
+                fill_lanes(to, h, coefficients[1]);
+                fill_K(from, to, h);
+                advance(0, 1);
+                if (to == jj - 1) break;
+                settle(to);
+                from = to;
+            }
+            level_D = 0;
+            fill_lanes(jj - 1, dT, coefficients[level_D]);
+        }
+        settle(jj - 1);
+    }
+
+    size_t m = spot_node(S0_) - 1;
+    for (size_t ll = 0; ll < L; ll++) {
+        prices[order[ll]] = F[m * L + ll];
+    }
+}
+
+/**
+ * @brief Prices several scenarios of the option's maturity and spot, advancing European and Bermudan scenarios in lock step.
+ *
+ * Each scenario is the option with its own contract type, strike and volatility, on the same mesh,
+ * rate curve lookups and dividend, barrier and exercise schedules; under a local volatility surface
+ * the volatility of a scenario scales the whole surface (see `scenario`).
+ *
+ * Several European or Bermudan scenarios are priced together by `sweep_lanes`, whatever their
+ * volatilities: one backward sweep over lanes stored as a structure of arrays, each lane with its
+ * own factorization. Every other scenario is priced by its own `solve`, as `price()` is: a single
+ * scenario, and each scenario of an American or barrier option, which have no lock-step solve
+ * (a projected SOR solve per scenario, strike-dependent boundaries). American scenarios thus get
+ * the projected SOR settings of the option, its divergence detection and restart, and their
+ * statistics are returned in `reports`; these scenarios are priced concurrently on `ThreadPool::global()`.
+ *
+ * @param scenarios Contract type, strike and volatility of each scenario.
+ * @param reports Receives the projected SOR statistics of each scenario, in the same order; may be null.
+ * @return Price at \( S_0 \) and \( T_0 \) of each scenario, in the same order.
+ */
+std::vector<double> Option::price_scenarios(const std::vector<Scenario>& scenarios, std::vector<ScenarioReport>* reports) const {
+    for (const Scenario& sc : scenarios) {
+        if (sc.contract_type != 1 && sc.contract_type != -1) throw InvalidContractType(sc.contract_type);
+        if (sc.K <= 0) throw InvalidStrike(sc.K);
+        if (sc.volatility <= 0) throw InvalidVolatility(sc.volatility);
+    }
+    size_t L = scenarios.size();
+    if (reports) reports->assign(L, ScenarioReport());
+    if (L == 0) return std::vector<double>();
+
+    // The scenarios are copies of a prototype without the grid.
+    Option proto(*this);
+    std::vector<double>().swap(proto.grid);
+    std::vector<double> prices(L);
+
+    bool lock_step = (exercise_type_ || !exercise_levels_.empty()) && barrier_.type == BarrierType::None;
+    if (lock_step && L > 1) {
+        std::vector<size_t> lanes(L);
+        for (size_t ll = 0; ll < L; ll++) {
+            lanes[ll] = ll;
+        }
+        proto.sweep_lanes(scenarios, lanes, prices.data());
+        return prices;
+    }
+
+    ThreadPool::global().run(L, [&](size_t ll) {
+        Option lane = proto.scenario(scenarios[ll]);
+        lane.create_grid();
+        lane.solve();
+        prices[ll] = lane.price();
+        if (reports) (*reports)[ll] = { lane.psor_sweeps_, std::move(lane.warnings_) };
+    });
+    return prices;
+}
+
+/**
+ * @brief Computes the key-rate rhos of the option, one per pillar of the interest rate curve.
+ *
+ * Pillar \( k \) is bumped by the absolute amount `bump` and the option is re-priced:
+ * \[
+ * \rho_k = \frac{\text{price}(r_k + \Delta r) - \text{price}(r)}{\Delta r}
+ * \]
+ * With linear interpolation the bump only changes the curve before the next pillar
+ * \( t_{k+1} \): the time levels at or after it, and the steps between them, are the same as in the
+ * base grid. Each bumped pricing therefore copies the base grid and restarts the backward sweep
+ * from the first level at or after \( t_{k+1} \); the bump of the last pillar, which also moves the
+ * flat extrapolation, needs a full sweep. The bumps are priced concurrently on `ThreadPool::global()`.
+ *
+ * The sum of the key-rate rhos is the rho of a parallel shift of the curve.
+ *
+ * @param bump Absolute bump of the rate of each pillar.
+ * @return Rho for each pillar, aligned with `InterestRate::points()`.
+ */
+std::vector<double> Option::bucketed_rho(double bump) const {
+    const std::vector<std::pair<double, double>>& points = curve->points();
+    size_t m = spot_node(S0_);
+    double base = grid[m];
+    std::vector<double> rho(points.size());
+
+    ThreadPool::global().run(points.size(), [&](size_t kk) {
+        std::vector<std::pair<double, double>> bumped = points;
+        bumped[kk].second += bump;
+
+        size_t start = time_mesh_ - 1;
+        if (kk + 1 < points.size()) {
+            double t_next = points[kk + 1].first;
+            for (size_t ii = 0; ii < time_mesh_ - 1; ii++) {
+                if (dT * ii >= t_next) {
+                    start = ii;
+                    break;
+                }
+            }
+        }
+
+        if (barrier_.type == BarrierType::UpIn || barrier_.type == BarrierType::DownIn) {
+            Option tmp = variant(mesh_input_, S_max_input_, std::make_shared<const InterestRate>(std::move(bumped)), 0, psor_);
+            rho[kk] = (tmp.grid[m] - base) / bump;
+            return;
+        }
+
+        Option tmp(*this);
+        tmp.curve = std::make_shared<const InterestRate>(std::move(bumped));
+        tmp.fill_curves();
+        {
+            ArenaScope pricing;
+            tmp.solve_from(start);
+        }
+        rho[kk] = (tmp.grid[m] - base) / bump;
+    });
+
+    return rho;
+}
+
+/**
+ * @brief Prices the option under several volatility scenarios.
+ *
+ * Runs `price_scenarios` with the option's contract type and strike.
+ *
+ * @param vols Volatility of each scenario.
+ * @return Price at \( S_0 \) and \( T_0 \) of each scenario, in the same order.
+ */
+std::vector<double> Option::vol_ladder(const std::vector<double>& vols) const {
+    std::vector<Scenario> scenarios;
+    scenarios.reserve(vols.size());
+    for (double vol : vols) {
+        scenarios.push_back({ contract_type_, K_, vol });
+    }
+    return price_scenarios(scenarios);
+}
+
+/**
+ * @brief Prices the option for several strikes on the option's own grid, with one factorization per time step.
+ *
+ * Options on the same underlying with the same maturity, contract type and volatility only differ
+ * by their payoffs and boundary values: runs `price_scenarios` with the option's contract type and
+ * volatility, which prices European and Bermudan strikes as the lanes of a single sweep, with one
+ * factorization and a substitution per strike at each time step. American and barrier options
+ * have no shared factorization and are priced strike by strike, concurrently.
+ *
+ * Works with a flat or a local volatility.
+ *
+ * @param strikes Strike of each option of the strip.
+ * @return Price at \( S_0 \) and \( T_0 \) for each strike, in the same order.
+ */
+std::vector<double> Option::strike_strip(const std::vector<double>& strikes) const {
+    std::vector<Scenario> scenarios;
+    scenarios.reserve(strikes.size());
+    for (double k : strikes) {
+        scenarios.push_back({ contract_type_, k, volatility_ });
+    }
+    return price_scenarios(scenarios);
+}
+
+/**
+ * @brief Computes the volga of the option.
+ *
+ * Volga is the second derivative of the price in the volatility, computed by central differences
+ * on the two bumped scenarios of `vol_ladder` and the price of the option:
+ * \[
+ * \text{volga} = \frac{\text{price}(\sigma + \Delta \sigma) - 2 \cdot \text{price}(\sigma) + \text{price}(\sigma - \Delta \sigma)}{\Delta \sigma^2}
+ * \]
+ *
+ * With a local volatility surface the bumps are relative: the whole surface is multiplied by
+ * \( 1 \pm h \), which moves \( \sigma = \sigma(S_0, 0) \) by \( \pm \Delta \sigma \) and, unlike an
+ * absolute shift of \( -\Delta \sigma \), keeps every node of the surface positive.
+ *
+ * @param h Proportional increment for the volatility (\( \Delta \sigma = \sigma \cdot h \)), below 1.
+ * @return The computed volga value.
+ */
+double Option::volga(double h) const {
+    double shift = volatility_ * h;
+    std::vector<double> p = vol_ladder({ volatility_ - shift, volatility_ + shift });
+    double mid = grid[spot_node(S0_)];
+
+    return (p[1] - 2 * mid + p[0]) / (shift * shift);
+}
+
+/**
+ * @brief Computes price, delta and gamma for a ladder of relative spot shifts with a single solve.
+ *
+ * The option is priced once on a grid with the same spot step and an upper bound
+ * \( S_{max} \max_k (1 + \text{shift}_k) \), so that every shifted spot sees at least the domain
+ * it would have if priced on its own. The ladder is then read from the first time level:
+ * - the price is the cubic Lagrange interpolant through the four nodes around the shifted spot;
+ * - delta and gamma are the central differences at those nodes, interpolated the same way.
+ *
+ * The reported error is the difference between the cubic and the linear interpolants of the
+ * price, which bounds the error of the linear one and overestimates the cubic one.
+ *
+ * For \( N \) shifts this replaces \( N \) pricings by one. A barrier option has a fixed domain,
+ * so its ladder is read from its own grid and the shifts must stay inside it.
+ *
+ * @param shifts Relative shifts of the spot.
+ * @return One point per shift, in the same order.
+ */
+std::vector<LadderPoint> Option::spot_ladder(const std::vector<double>& shifts) const {
+    double widest = 1;
+    for (double shift : shifts) {
+        widest = std::max(widest, 1 + shift);
+    }
+    unsigned int mesh = static_cast<unsigned int>(std::ceil(S_max_ * widest / dS - 1e-9));
+    Option wide = barrier_.type == BarrierType::None ? variant(mesh, mesh * dS, curve, 0, psor_) : *this;
+    mesh = wide.spot_mesh_;
+    const double* V = wide.grid.data();
+
+    std::vector<LadderPoint> ladder;
+    ladder.reserve(shifts.size());
+    for (double shift : shifts) {
+        double S = S0_ * (1 + shift);
+        double x = (S - S_min_) / dS;
+        size_t j = static_cast<size_t>(std::floor(x));
+        if (S <= 0 || j < 2 || j + 3 > mesh) throw InvalidShift(shift);
+        double t = x - j;
+
+        // Cubic Lagrange weights on the nodes j - 1, j, j + 1, j + 2.
+        double w[4] = {
+            -t * (t - 1) * (t - 2) / 6,
+            (t + 1) * (t - 1) * (t - 2) / 2,
+            -(t + 1) * t * (t - 2) / 2,
+            (t + 1) * t * (t - 1) / 6
+        };
+
+        LadderPoint point = { shift, S, 0, 0, 0, 0 };
+        for (size_t kk = 0; kk < 4; kk++) {
+            size_t m = j - 1 + kk;
+            point.price += w[kk] * V[m];
+            point.delta += w[kk] * (V[m + 1] - V[m - 1]) / (2 * dS);
+            point.gamma += w[kk] * (V[m + 1] - 2 * V[m] + V[m - 1]) / (dS * dS);
+        }
+        point.error = std::fabs(point.price - ((1 - t) * V[j] + t * V[j + 1]));
+        ladder.push_back(point);
+    }
+    return ladder;
+}
+
+/**
+ * @brief Returns the number of PSOR sweeps performed by the pricing.
+ *
+ * Always 0 for European options.
+ *
+ * @return Total number of sweeps over all the time steps.
+ */
+size_t Option::psor_sweeps() const {
+    return psor_sweeps_;
+}
+
+/**
+ * @brief Computes the PSOR sweeps saved with respect to the fixed-omega baseline.
+ *
+ * Re-prices the option with `PSORSettings::baseline()`, i.e. the fixed relaxation `w` and no
+ * extrapolation of the initial guess, and compares the total number of sweeps.
+ *
+ * @return Sweeps of the baseline minus sweeps of this pricing (negative if the baseline was faster).
+ */
+long Option::psor_sweeps_saved() const {
+    Option tmp = variant(mesh_input_, S_max_input_, curve, 0, psor_.baseline());
+
+    return static_cast<long>(tmp.psor_sweeps()) - static_cast<long>(psor_sweeps_);
+}
+
+/**
+ * @brief Returns the convergence statistics of each PSOR solve.
+ *
+ * Entry \( i \) describes the solve of time level \( i \); the last level is the payoff and
+ * has no entry.
+ *
+ * @return Statistics per time level, empty for European options.
+ */
+const std::vector<PSORStats>& Option::psor_convergence() const {
+    return psor_steps_;
+}
+
+/**
+ * @brief Returns the time steps at which the PSOR solver hit its sweep cap or diverged.
+ *
+ * A non-converged step does not stop the pricing: its price is the last iterate and the step is
+ * reported here, in time order from maturity backwards.
+ *
+ * @return Warnings of the last pricing.
+ */
+const std::vector<PSORWarning>& Option::warnings() const {
+    return warnings_;
 }
\ No newline at end of file
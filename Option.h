@@ -6,39 +6,192 @@
 #pragma once
 
 #include "InterestRate.h"
+#include "LocalVol.h"
 #include "OptionExceptions.h"
+#include "ProjectedSOR.h"
 #include "Tridiag.h"
 
+#include <cmath>
+#include <string>
 #include <vector>
 
+/**
+ * @brief Contract of one scenario of a batch pricing.
+ */
+struct Scenario {
+    int contract_type; ///< 1 for Call, -1 for Put.
+    double K;          ///< Strike price.
+    double volatility; ///< Volatility of the underlying asset.
+};
+
+/**
+ * @brief Cash dividend paid by the underlying asset.
+ */
+struct Dividend {
+    double time;   ///< Ex-dividend time, on the clock of the interest rate curve.
+    double amount; ///< Cash amount, deducted from the spot on the ex-dividend time.
+};
+
+/**
+ * @brief Kind of barrier of an option.
+ */
+enum class BarrierType {
+    None,    ///< Vanilla option.
+    UpOut,   ///< Knocked out when the spot reaches the barrier from below.
+    DownOut, ///< Knocked out when the spot reaches the barrier from above.
+    UpIn,    ///< Becomes a vanilla option when the spot reaches the barrier from below.
+    DownIn   ///< Becomes a vanilla option when the spot reaches the barrier from above.
+};
+
+/**
+ * @brief Barrier of an option, monitored continuously or on a schedule.
+ */
+struct Barrier {
+    BarrierType type;               ///< Kind of barrier.
+    double level;                   ///< Barrier level.
+    double rebate;                  ///< Cash paid when a knock-out barrier is hit; must be 0 for knock-ins.
+    std::vector<double> monitoring; ///< Monitoring times, on the clock of the dividend times; empty for continuous monitoring.
+
+    /**
+     * @brief Constructs a barrier.
+     * @param type Kind of barrier.
+     * @param level Barrier level.
+     * @param rebate Cash paid when a knock-out barrier is hit.
+     * @param monitoring Monitoring times; empty for continuous monitoring.
+     */
+    Barrier(BarrierType type = BarrierType::None, double level = 0, double rebate = 0, std::vector<double> monitoring = std::vector<double>())
+        : type(type), level(level), rebate(rebate), monitoring(std::move(monitoring)) {}
+};
+
+/**
+ * @brief Price and spot Greeks at one point of a spot ladder.
+ */
+struct LadderPoint {
+    double shift; ///< Relative shift of the spot.
+    double spot;  ///< Shifted spot \( S_0 (1 + \text{shift}) \).
+    double price; ///< Option price at the shifted spot.
+    double delta; ///< Delta at the shifted spot.
+    double gamma; ///< Gamma at the shifted spot.
+    double error; ///< Estimate of the interpolation error on the price.
+};
+
+/**
+ * @brief Time step at which the projected SOR solver did not converge.
+ */
+struct PSORWarning {
+    size_t step;         ///< Index of the time level that was solved.
+    double time;         ///< Time of that level.
+    PSORStats stats;     ///< Convergence statistics of the solve.
+    std::string message; ///< Human-readable description.
+};
+
+/**
+ * @brief Projected SOR statistics of one scenario of a batch pricing.
+ */
+struct ScenarioReport {
+    size_t sweeps;                     ///< Total number of PSOR sweeps; 0 for European and Bermudan exercise.
+    std::vector<PSORWarning> warnings; ///< Time steps at which the solver hit its sweep cap or diverged.
+};
+
  /**
   * @class Option
   * @brief Represents an option contract with numerical pricing methods using finite difference techniques.
   */
 class Option {
+    /**
+     * @brief Event falling strictly between two time levels, at which the step between them is split.
+     */
+    struct Stop {
+        double time;     ///< Time of the event, on the clock of the rate curve.
+        size_t level;    ///< Time level before the event: the step from `level + 1` to `level` is split.
+        double dividend; ///< Cash dividend paid at the event, 0 if none.
+        bool exercise;   ///< Exercise date of a Bermudan option.
+        bool monitor;    ///< Monitoring time of a discrete barrier.
+    };
+
     int contract_type_;
     int exercise_type_;
     double T_;
     double K_;
     double T0_;
     double S0_;
+    double S_max_;
     double volatility_;
+    LocalVolHandle local_vol_;
     unsigned int time_mesh_;
     unsigned int spot_mesh_;
-    std::vector<std::pair<double, double>> interest_rate_;
-    InterestRate curve;
+    InterestRateHandle curve;
     double dT;
     double dS;
     double F0;
     double FM;
-    std::vector<std::vector<double>> grid;
-    std::vector<double> F;
-    double tol_;
-    double w_;
+    std::vector<double> grid;
+    std::vector<double> sigma2_;
+    std::vector<Dividend> dividends_;
+    std::vector<double> jumps_;
+    InterestRateHandle dividend_yield_;
+    InterestRateHandle repo_;
+    std::vector<double> rates_;
+    std::vector<double> drifts_;
+    std::vector<double> discounts_;
+    std::vector<double> carries_;
+    PSORSettings psor_;
+    size_t psor_sweeps_;
+    std::vector<PSORStats> psor_steps_;
+    std::vector<PSORWarning> warnings_;
+    Barrier barrier_;
+    unsigned int mesh_input_;
+    double S_max_input_;
+    double S_min_;
+    double j0_;
+    size_t barrier_node_;
+    std::vector<double> edge_;
+    bool zero_payoff_;
+    std::vector<double> exercise_dates_;
+    std::vector<char> exercise_levels_;
+    std::vector<char> monitor_levels_;
+    std::vector<double> knock_values_;
+    std::vector<Stop> stops_;
 
+    void setup();
+    void setup_barrier();
+    void solve_knock_in();
+    bool vanilla_domain() const { return barrier_.type == BarrierType::None && S_min_ == 0; }
+    double lower_boundary(size_t i) const;
+    double upper_boundary(size_t i) const;
+    size_t spot_node(double S) const { return static_cast<size_t>(std::round((S - S_min_) / dS)); }
+    size_t instants() const { return time_mesh_ + stops_.size(); }
+    double time_at(size_t i) const { return i < time_mesh_ ? dT * i : stops_[i - time_mesh_].time; }
+    bool locate_level(double t, size_t& k) const;
+    size_t add_stop(double t, size_t k);
+    std::pair<size_t, size_t> stop_range(size_t k) const;
+    double dividend_at(size_t i) const;
+    bool exercise_at(size_t i) const;
+    bool monitor_at(size_t i) const;
+    std::vector<char> schedule_levels(const std::vector<double>& times, std::vector<double>& between) const;
+    void fill_schedules();
+    void exercise(size_t i);
+    void knock_out(size_t i);
     void create_grid();
-    void european_price();
-    void american_price();
+    void fill_local_vol();
+    void fill_curves();
+    void fill_jumps();
+    void dividend_jump(const double* in, const double* low, double* out, size_t lanes, double amount) const;
+    double sigma2(size_t j, size_t i) const { return sigma2_.empty() ? volatility_ * volatility_ : sigma2_[i * (spot_mesh_ + 1) + j]; }
+    double* level(size_t i) { return grid.data() + i * (spot_mesh_ + 1); }
+    double& node(size_t j, size_t i) { return grid[i * (spot_mesh_ + 1) + j]; }
+    void fill_coefficients(size_t i, double h, ScratchVector& a, ScratchVector& b, ScratchVector& c) const;
+    std::pair<double, double> step_K(size_t from, size_t to, double h) const;
+    bool same_coefficients(size_t i, size_t k) const;
+    static void assign_C(const ScratchVector& a, const ScratchVector& b, const ScratchVector& c, Tridiag& C);
+    static void assign_D(const ScratchVector& a, const ScratchVector& b, const ScratchVector& c, Tridiag& D);
+    void solve_from(size_t start);
+    void european_price(size_t start);
+    void american_price(ScratchVector& F, size_t start);
+    Option variant(unsigned int spot_mesh, double S_max, InterestRateHandle rate_curve, double vol_shift, const PSORSettings& psor) const;
+    void set_contract(int contract_type, double K);
+    Option scenario(const Scenario& sc) const;
+    void sweep_lanes(const std::vector<Scenario>& scenarios, const std::vector<size_t>& lanes, double* prices);
 
 public:
     /**
@@ -54,30 +207,78 @@ public:
      * @param interest_rate Interest rate curve as pairs (time, rate).
      * @param volatility Volatility of the underlying asset.
      * @param tol Convergence tolerance for iterative solvers.
-     * @param w Relaxation parameter for iterative solvers.
+     * @param w Relaxation parameter for iterative solvers, kept fixed (`PSORSettings::baseline()`).
      */
     Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, std::vector<std::pair<double, double>> interest_rate, double volatility, double tol = 1e-12, double w = 1.2);
 
+    /**
+     * @brief Constructs an Option object on a shared interest rate curve.
+     * @param contract_type Type of contract (1 for Call, -1 for Put).
+     * @param exercise_type Exercise type (0 for European, 1 for American).
+     * @param T Maturity of the option.
+     * @param K Strike price.
+     * @param T0 Initial time.
+     * @param time_mesh Number of time steps in the grid.
+     * @param spot_mesh Number of spot steps in the grid.
+     * @param S0 Initial spot price.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param volatility Volatility of the underlying asset.
+     * @param psor Settings of the projected SOR solver used for American exercise.
+     * @param S_max Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+     * @param dividends Cash dividends of the underlying asset.
+     * @param dividend_yield Continuous dividend yield curve \( q(t) \); null for no yield.
+     * @param repo Repo (stock borrow) rate curve, lowering the drift like the dividend yield; null for none.
+     * @param barrier Barrier of the option; none by default.
+     * @param exercise_dates Exercise times of a Bermudan option (exercise type 0), on the clock of the dividend times; empty for exercise at every time step.
+     */
+    Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, InterestRateHandle rate_curve, double volatility, const PSORSettings& psor = PSORSettings(), double S_max = 0, std::vector<Dividend> dividends = std::vector<Dividend>(),
+        InterestRateHandle dividend_yield = nullptr, InterestRateHandle repo = nullptr, const Barrier& barrier = Barrier(),
+        std::vector<double> exercise_dates = std::vector<double>());
+
+    /**
+     * @brief Constructs an Option object under a local volatility surface.
+     * @param contract_type Type of contract (1 for Call, -1 for Put).
+     * @param exercise_type Exercise type (0 for European, 1 for American).
+     * @param T Maturity of the option.
+     * @param K Strike price.
+     * @param T0 Initial time.
+     * @param time_mesh Number of time steps in the grid.
+     * @param spot_mesh Number of spot steps in the grid.
+     * @param S0 Initial spot price.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param local_vol Shared, immutable local volatility surface.
+     * @param psor Settings of the projected SOR solver used for American exercise.
+     * @param S_max Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+     * @param dividends Cash dividends of the underlying asset.
+     * @param dividend_yield Continuous dividend yield curve \( q(t) \); null for no yield.
+     * @param repo Repo (stock borrow) rate curve, lowering the drift like the dividend yield; null for none.
+     * @param barrier Barrier of the option; none by default.
+     * @param exercise_dates Exercise times of a Bermudan option (exercise type 0), on the clock of the dividend times; empty for exercise at every time step.
+     */
+    Option(int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh, unsigned int spot_mesh, double S0, InterestRateHandle rate_curve, LocalVolHandle local_vol, const PSORSettings& psor = PSORSettings(), double S_max = 0, std::vector<Dividend> dividends = std::vector<Dividend>(),
+        InterestRateHandle dividend_yield = nullptr, InterestRateHandle repo = nullptr, const Barrier& barrier = Barrier(),
+        std::vector<double> exercise_dates = std::vector<double>());
+
     /**
      * @brief Computes the coefficients a_j for the tridiagonal matrix.
      * @param i Time step index.
      * @return Vector of coefficients a_j.
      */
-    std::vector<double> compute_aj(size_t i);
+    ScratchVector compute_aj(size_t i);
 
     /**
      * @brief Computes the coefficients b_j for the tridiagonal matrix.
      * @param i Time step index.
      * @return Vector of coefficients b_j.
      */
-    std::vector<double> compute_bj(size_t i);
+    ScratchVector compute_bj(size_t i);
 
     /**
      * @brief Computes the coefficients c_j for the tridiagonal matrix.
      * @param i Time step index.
      * @return Vector of coefficients c_j.
      */
-    std::vector<double> compute_cj(size_t i);
+    ScratchVector compute_cj(size_t i);
 
     /**
      * @brief Computes the tridiagonal matrix C.
@@ -86,7 +287,7 @@ public:
      * @param c Vector of coefficients c_j.
      * @return Tridiagonal matrix C.
      */
-    Tridiag compute_C(std::vector<double> a, std::vector<double> b, std::vector<double> c);
+    Tridiag compute_C(ScratchVector a, ScratchVector b, ScratchVector c);
 
     /**
      * @brief Computes the tridiagonal matrix D.
@@ -95,7 +296,7 @@ public:
      * @param c Vector of coefficients c_j.
      * @return Tridiagonal matrix D.
      */
-    Tridiag compute_D(std::vector<double> a, std::vector<double> b, std::vector<double> c);
+    Tridiag compute_D(ScratchVector a, ScratchVector b, ScratchVector c);
 
     /**
      * @brief Computes the vector K for the boundary conditions.
@@ -106,6 +307,8 @@ public:
 
     /**
      * @brief Solves the option pricing problem using the grid.
+     *
+     * Scratch memory is drawn from the thread-local arena and released when the solve returns.
      */
     void solve();
 
@@ -148,8 +351,79 @@ public:
 
     /**
      * @brief Computes the rho of the option.
-     * @param h Step size for finite difference, default value is 0.01
+     * @param h Step size for finite difference, relative to the first rate of the curve or absolute
+     * if that rate is 0; default value is 0.01
      * @return Rho of the option.
      */
     double rho(double h = 0.01);
+
+    /**
+     * @brief Prices several scenarios of the option's maturity and spot, advancing European and Bermudan scenarios in lock step.
+     * @param scenarios Contract type, strike and volatility of each scenario.
+     * @param reports Receives the projected SOR statistics of each scenario, in the same order; may be null.
+     * @return Price at \( S_0 \) and \( T_0 \) of each scenario, in the same order.
+     */
+    std::vector<double> price_scenarios(const std::vector<Scenario>& scenarios, std::vector<ScenarioReport>* reports = nullptr) const;
+
+    /**
+     * @brief Prices the option under several volatility scenarios.
+     * @param vols Volatility of each scenario.
+     * @return Price at \( S_0 \) and \( T_0 \) of each scenario, in the same order.
+     */
+    std::vector<double> vol_ladder(const std::vector<double>& vols) const;
+
+    /**
+     * @brief Prices the option for several strikes on the option's own grid, with one factorization per time step.
+     * @param strikes Strike of each option of the strip.
+     * @return Price at \( S_0 \) and \( T_0 \) for each strike, in the same order.
+     */
+    std::vector<double> strike_strip(const std::vector<double>& strikes) const;
+
+    /**
+     * @brief Computes the key-rate rhos of the option, one per pillar of the interest rate curve.
+     * @param bump Absolute bump of the rate of each pillar, default value is 1e-4
+     * @return Rho for each pillar, aligned with the curve points.
+     */
+    std::vector<double> bucketed_rho(double bump = 1e-4) const;
+
+    /**
+     * @brief Computes the volga (second derivative of the price in the volatility).
+     * @param h Proportional step for the volatility, default value is 0.01
+     * @return Volga of the option.
+     */
+    double volga(double h = 0.01) const;
+
+    /**
+     * @brief Computes price, delta and gamma for a ladder of relative spot shifts with a single solve.
+     * @param shifts Relative shifts of the spot, e.g. -0.2, -0.1, 0.1, 0.2.
+     * @return One point per shift, in the same order.
+     */
+    std::vector<LadderPoint> spot_ladder(const std::vector<double>& shifts) const;
+
+    /**
+     * @brief Returns the number of PSOR sweeps performed by the pricing.
+     * @return Total number of sweeps, 0 for European options.
+     */
+    size_t psor_sweeps() const;
+
+    /**
+     * @brief Computes the PSOR sweeps saved with respect to the fixed-omega baseline.
+     *
+     * Re-prices the option with a fixed relaxation and no extrapolation.
+     *
+     * @return Sweeps of the baseline minus sweeps of this pricing.
+     */
+    long psor_sweeps_saved() const;
+
+    /**
+     * @brief Returns the convergence statistics of each PSOR solve.
+     * @return One entry per time level, indexed like the grid columns; empty for European options.
+     */
+    const std::vector<PSORStats>& psor_convergence() const;
+
+    /**
+     * @brief Returns the time steps at which the PSOR solver hit its sweep cap or diverged.
+     * @return Warnings of the last pricing, empty if every step converged.
+     */
+    const std::vector<PSORWarning>& warnings() const;
 };
\ No newline at end of file
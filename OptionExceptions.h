@@ -226,6 +226,311 @@ public:
         msg += std::to_string(N);
     }
 
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when an invalid spot domain is encountered.
+ *
+ * The upper bound of the spot grid must be above the spot price.
+ */
+class InvalidDomain : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid domain bound.
+     * @param N The invalid upper bound received.
+     */
+    InvalidDomain(double N) {
+        msg = "Invalid spot domain, upper bound must be above the spot price, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a spot shift moves the spot outside the pricing grid.
+ *
+ * Shifted spots need two grid nodes on each side for the interpolation.
+ */
+class InvalidShift : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid shift.
+     * @param N The invalid relative shift received.
+     */
+    InvalidShift(double N) {
+        msg = "Invalid spot shift, shifted spot must lie inside the grid, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a local volatility surface is malformed.
+ *
+ * Spot and time pillars must be non-empty and strictly increasing, and there must be one
+ * positive volatility per pair of pillars.
+ */
+class InvalidLocalVol : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the offending value.
+     * @param N The invalid pillar, volatility or size received.
+     */
+    InvalidLocalVol(double N) {
+        msg = "Invalid local volatility surface, pillars must be increasing and volatilities positive, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a dividend has an invalid amount.
+ *
+ * Cash dividends must be non-negative.
+ */
+class InvalidDividend : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid amount.
+     * @param N The invalid dividend amount received.
+     */
+    InvalidDividend(double N) {
+        msg = "Invalid dividend, amount must be non-negative, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a barrier is inconsistent with the spot price.
+ *
+ * Up barriers must lie above the spot price and down barriers below it; knock-in barriers
+ * take no rebate.
+ */
+class InvalidBarrier : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid barrier level or rebate received.
+     */
+    InvalidBarrier(double N) {
+        msg = "Invalid barrier, up barriers must be above the spot and down barriers below it, knock-ins take no rebate, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when an exercise or monitoring schedule is invalid.
+ *
+ * Schedule times must lie between 0 and \( T - T_0 \), and exercise dates are only accepted with
+ * exercise type 0.
+ */
+class InvalidSchedule : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid time or exercise type received.
+     */
+    InvalidSchedule(double N) {
+        msg = "Invalid schedule, times must lie between 0 and T - T0 and exercise dates need exercise type 0, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when the parameters of the Heston model or its grid are invalid.
+ *
+ * The variances and the speed of mean reversion must be non-negative, the volatility of the
+ * variance positive and the correlation in \( [-1, 1] \); the variance grid needs at least 3 steps
+ * and an upper bound above the initial variance.
+ */
+class InvalidHeston : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid parameter received.
+     */
+    InvalidHeston(double N) {
+        msg = "Invalid Heston parameters, variances and mean reversion must be non-negative, vol of variance positive, correlation in [-1, 1], at least 3 variance steps and v_max above v0, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when the correlation of two underlying assets is outside \( [-1, 1] \).
+ */
+class InvalidCorrelation : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid correlation received.
+     */
+    InvalidCorrelation(double N) {
+        msg = "Invalid correlation, must be between -1 and 1, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when the averaging of an Asian option is invalid.
+ *
+ * The average needs at least one fixing, past or future; the running average of the past fixings
+ * must lie between 0 and the top of the grid, and the average grid needs at least 2 steps.
+ */
+class InvalidAverage : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid parameter received.
+     */
+    InvalidAverage(double N) {
+        msg = "Invalid averaging, at least one fixing, a past average between 0 and S_max and at least 2 average steps are required, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a trade file cannot be read or written.
+ *
+ * A binary trade file must start with the trade header of the current version and hold exactly the
+ * number of records it declares; every data line of a CSV trade file needs the eleven numeric fields of
+ * a `TradeRecord`. The value received is the CSV line at fault, the size of a malformed binary file,
+ * or -1 when the file cannot be opened.
+ */
+class InvalidTradeFile : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid parameter received.
+     */
+    InvalidTradeFile(double N) {
+        msg = "Invalid trade file, a readable binary file with a valid header and whole records or a CSV with 11 numeric fields per line is required, value received: ";
+        msg += std::to_string(N);
+    }
+
+    /**
+     * @brief Override the 'what()' method to return the custom error message.
+     * @return The error message as a C-string.
+     */
+    virtual const char* what() const throw() {
+        return msg.c_str();
+    }
+};
+
+/**
+ * @brief Exception thrown when a result file cannot be written.
+ *
+ * The value received is the number of rows written before the failure, or -1 when the file cannot
+ * be opened.
+ */
+class InvalidResultFile : public OptionExceptions {
+    std::string msg;
+
+public:
+    /**
+     * @brief Constructor to initialize the error message with the invalid value.
+     * @param N The invalid parameter received.
+     */
+    InvalidResultFile(double N) {
+        msg = "Invalid result file, a writable file is required, value received: ";
+        msg += std::to_string(N);
+    }
+
     /**
      * @brief Override the 'what()' method to return the custom error message.
      * @return The error message as a C-string.
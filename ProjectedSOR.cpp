@@ -0,0 +1,405 @@
+/**
+ * @file ProjectedSOR.cpp
+ * @brief Contains the sweeps of the projected SOR solver, in natural and red-black ordering.
+ */
+
+#include "ProjectedSOR.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ /**
+  * @brief Minimum number of nodes of one colour handled by a task of a red-black half-sweep.
+  */
+static const size_t RED_BLACK_GRAIN = 2048;
+
+/**
+ * @brief Ratio of the golden-section search on the relaxation parameter.
+ */
+static const double GOLDEN = 0.6180339887498949;
+
+/**
+ * @brief Width of the bracket at which the relaxation search stops.
+ */
+static const double SEARCH_WIDTH = 0.02;
+
+/**
+ * @brief Constructs the solver.
+ * @param settings Solver parameters.
+ */
+ProjectedSOR::ProjectedSOR(const PSORSettings& settings)
+    : settings_(settings), omega_(settings.w), tuned_(false), lo_(1.0), hi_(2.0), c_(1.0), d_(1.0), fc_(0), fd_(0), probe_c_(true), stage_(0) {}
+
+/**
+ * @brief Estimates the spectral radius of the Jacobi iteration matrix of \( C \).
+ *
+ * The number of eigenvalues of the symmetric tridiagonal matrix below \( x \) is the number of
+ * negative pivots of its \( LDL^T \) factorization shifted by \( x \). The largest eigenvalue is
+ * bisected between 0 and the Gershgorin bound until the interval is below \( 10^{-12} \).
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @return Spectral radius of the Jacobi iteration.
+ */
+double ProjectedSOR::jacobi_radius(const Tridiag& C) {
+    const ScratchVector& l = C.subdiag();
+    const ScratchVector& d = C.diag();
+    const ScratchVector& u = C.superdiag();
+    size_t n = d.size();
+    if (n < 2) return 0;
+
+    ScratchVector e2(n - 1);
+    double hi = 0;
+    for (size_t ii = 0; ii < n - 1; ii++) {
+        e2[ii] = std::fabs(l[ii] * u[ii] / (d[ii] * d[ii + 1]));
+    }
+    for (size_t ii = 0; ii < n; ii++) {
+        double row = (ii > 0 ? std::sqrt(e2[ii - 1]) : 0.0) + (ii < n - 1 ? std::sqrt(e2[ii]) : 0.0);
+        hi = std::max(hi, row);
+    }
+
+    double lo = 0;
+    while (hi - lo > 1e-12) {
+        double x = 0.5 * (lo + hi);
+        size_t below = 0;
+        double q = -x;
+        for (size_t ii = 0;; ii++) {
+            if (q < 0) below++;
+            if (ii == n - 1) break;
+            if (q == 0) q = -1e-300;
+            q = -x - e2[ii] / q;
+        }
+        if (below == n) hi = x;
+        else lo = x;
+    }
+    return hi;
+}
+
+/**
+ * @brief Returns the optimal SOR relaxation for a given Jacobi spectral radius.
+ * @param rho Spectral radius of the Jacobi iteration.
+ * @return \( 2 / (1 + \sqrt{1 - \rho^2}) \).
+ */
+double ProjectedSOR::optimal_omega(double rho) {
+    double rho2 = std::min(rho * rho, 1.0 - 1e-8);
+    return 2.0 / (1.0 + std::sqrt(1.0 - rho2));
+}
+
+/**
+ * @brief Records the convergence rate of the current probe and moves the golden-section search.
+ *
+ * The two probes \( c < d \) of the bracket are evaluated on successive systems; the bracket
+ * then shrinks towards the probe with the faster contraction and a single new probe is evaluated
+ * per system. The search stops when the bracket is narrower than `SEARCH_WIDTH`, keeping the best probe.
+ *
+ * The mean logarithmic contraction of the updates per sweep is used rather than the sweep count,
+ * which is an integer and also depends on how far the initial guess is from the solution.
+ *
+ * @param rate Mean logarithmic contraction per sweep of the system solved with the current probe.
+ */
+void ProjectedSOR::search(double rate) {
+    if (probe_c_) fc_ = rate;
+    else fd_ = rate;
+
+    if (stage_ == 0) {
+        stage_ = 1;
+        probe_c_ = false;
+        return;
+    }
+
+    if (fc_ <= fd_) {
+        hi_ = d_;
+        d_ = c_;
+        fd_ = fc_;
+        c_ = hi_ - GOLDEN * (hi_ - lo_);
+        probe_c_ = true;
+    }
+    else {
+        lo_ = c_;
+        c_ = d_;
+        fc_ = fd_;
+        d_ = lo_ + GOLDEN * (hi_ - lo_);
+        probe_c_ = false;
+    }
+
+    if (hi_ - lo_ < SEARCH_WIDTH) {
+        omega_ = fc_ <= fd_ ? c_ : d_;
+        tuned_ = true;
+    }
+}
+
+/**
+ * @brief Tells which ordering is used for a system of the given size.
+ *
+ * `Auto` selects the red-black ordering from `parallel_threshold` nodes, where the parallel
+ * half-sweeps pay for their synchronization.
+ *
+ * @param n Number of unknowns.
+ * @return `GaussSeidel` or `RedBlack`.
+ */
+PSOROrdering ProjectedSOR::ordering(size_t n) const {
+    if (settings_.ordering != PSOROrdering::Auto) return settings_.ordering;
+    return n >= settings_.parallel_threshold ? PSOROrdering::RedBlack : PSOROrdering::GaussSeidel;
+}
+
+/**
+ * @brief Performs one projected SOR sweep in natural ordering.
+ *
+ * The update is done in place: node \( i \) sees the new value of node \( i - 1 \) and the
+ * old value of node \( i + 1 \).
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle.
+ * @param x Current iterate, updated in place.
+ * @return Euclidean norm of the update.
+ */
+double ProjectedSOR::sweep_gauss_seidel(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x) const {
+    const ScratchVector& l = C.subdiag();
+    const ScratchVector& d = C.diag();
+    const ScratchVector& u = C.superdiag();
+    const double w = omega_;
+    size_t n = x.size();
+    double som = 0, prev, diff;
+
+    prev = x[0];
+    x[0] = std::max(g[0], x[0] + (w / d[0]) * (b[0] - d[0] * x[0] - u[0] * x[1]));
+    diff = prev - x[0];
+    som += diff * diff;
+
+    size_t ii = 1;
+    for (; ii < n - 1; ii++) {
+        prev = x[ii];
+        x[ii] = std::max(g[ii], x[ii] + (w / d[ii]) * (b[ii] - l[ii - 1] * x[ii - 1] - d[ii] * x[ii] - u[ii] * x[ii + 1]));
+        diff = prev - x[ii];
+        som += diff * diff;
+    }
+
+    prev = x[ii];
+    x[ii] = std::max(g[ii], x[ii] + (w / d[ii]) * (b[ii] - l[ii - 1] * x[ii - 1] - d[ii] * x[ii]));
+    diff = prev - x[ii];
+    som += diff * diff;
+
+    return std::sqrt(som);
+}
+
+/**
+ * @brief Relaxes the nodes of one colour in the range `[lo, hi)`.
+ *
+ * `lo` and `hi` have the parity of the colour; the nodes are visited with stride 2. The two end
+ * nodes of the system are peeled off so that the main loop is branch-free and vectorizable.
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle.
+ * @param x Current iterate, updated in place.
+ * @param lo First node of the range.
+ * @param hi Bound of the range (exclusive).
+ * @return Sum of the squared updates.
+ */
+double ProjectedSOR::relax_colour(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, size_t lo, size_t hi) const {
+    const double* l = C.subdiag().data();
+    const double* d = C.diag().data();
+    const double* u = C.superdiag().data();
+    const double* pb = b.data();
+    const double* pg = g.data();
+    double* px = x.data();
+    const double w = omega_;
+    size_t n = x.size();
+    double som = 0;
+
+    bool head = lo == 0 && lo < hi;
+    bool tail = lo <= n - 1 && n - 1 < hi && (n - 1 - lo) % 2 == 0 && n > 1;
+    if (head) {
+        double next = std::max(pg[0], px[0] + (w / d[0]) * (pb[0] - d[0] * px[0] - u[0] * px[1]));
+        som += (next - px[0]) * (next - px[0]);
+        px[0] = next;
+        lo += 2;
+    }
+    size_t end = tail ? n - 1 : hi;
+    for (size_t ii = lo; ii < end; ii += 2) {
+        double next = std::max(pg[ii], px[ii] + (w / d[ii]) * (pb[ii] - l[ii - 1] * px[ii - 1] - d[ii] * px[ii] - u[ii] * px[ii + 1]));
+        som += (next - px[ii]) * (next - px[ii]);
+        px[ii] = next;
+    }
+    if (tail) {
+        size_t ii = n - 1;
+        double next = std::max(pg[ii], px[ii] + (w / d[ii]) * (pb[ii] - l[ii - 1] * px[ii - 1] - d[ii] * px[ii]));
+        som += (next - px[ii]) * (next - px[ii]);
+        px[ii] = next;
+    }
+    return som;
+}
+
+/**
+ * @brief Performs one projected SOR sweep in red-black ordering.
+ *
+ * The even nodes are relaxed first, then the odd ones. Within a half-sweep the updates are
+ * independent, so the nodes are split in chunks dispatched on `ThreadPool::global()`; the
+ * squared updates are reduced in chunk order, which keeps the result deterministic.
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle.
+ * @param x Current iterate, updated in place.
+ * @param partial Buffer for the per-chunk sums, one entry per chunk.
+ * @return Euclidean norm of the update.
+ */
+double ProjectedSOR::sweep_red_black(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, ScratchVector& partial) const {
+    size_t n = x.size();
+    size_t chunks = partial.size();
+    double som = 0;
+
+    for (size_t colour = 0; colour < 2; colour++) {
+        size_t count = (n - colour + 1) / 2;
+        ThreadPool::global().run(chunks, [&](size_t kk) {
+            size_t lo = colour + 2 * (count * kk / chunks);
+            size_t hi = colour + 2 * (count * (kk + 1) / chunks);
+            partial[kk] = relax_colour(C, b, g, x, lo, hi);
+        });
+        for (size_t kk = 0; kk < chunks; kk++) {
+            som += partial[kk];
+        }
+    }
+
+    return std::sqrt(som);
+}
+
+/**
+ * @brief Returns the residual of the complementarity problem at an iterate.
+ *
+ * Norm of \( \min(x - g, C x - b) \), which vanishes exactly at the solution; infinite when an
+ * entry is not finite.
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle.
+ * @param x Iterate.
+ * @return Euclidean norm of the componentwise residual.
+ */
+double ProjectedSOR::residual(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, const ScratchVector& x) {
+    const ScratchVector& l = C.subdiag();
+    const ScratchVector& d = C.diag();
+    const ScratchVector& u = C.superdiag();
+    size_t n = x.size();
+    double som = 0;
+    for (size_t ii = 0; ii < n; ii++) {
+        double Cx = d[ii] * x[ii];
+        if (ii > 0) Cx += l[ii - 1] * x[ii - 1];
+        if (ii + 1 < n) Cx += u[ii] * x[ii + 1];
+        double r = std::min(x[ii] - g[ii], Cx - b[ii]);
+        som += r * r;
+    }
+    return std::isfinite(som) ? std::sqrt(som) : std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Sweeps until convergence, divergence or exhaustion of the budget.
+ *
+ * Divergence is a non-finite update norm or a norm larger than `PSORSettings::divergence` times
+ * the smallest one seen so far.
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle.
+ * @param x Current iterate, updated in place.
+ * @param partial Per-chunk buffer of the red-black sweeps, empty for Gauss-Seidel.
+ * @param budget Maximum number of sweeps.
+ * @param stats Incremented by the sweeps performed; receives the last update norm.
+ * @param first Set to the update norm of the first sweep.
+ * @param best If not null, receives a copy of each iterate whose residual is below `best_residual`.
+ * @param best_residual Residual of `best`, lowered when a better iterate is copied.
+ * @return Outcome of the iteration.
+ */
+PSORStatus ProjectedSOR::iterate(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, ScratchVector& partial,
+    size_t budget, PSORStats& stats, double& first, ScratchVector* best, double* best_residual) const {
+    double smallest = 0;
+    double error = 1e6;
+
+    for (size_t sweeps = 0; error > settings_.tol; sweeps++) {
+        if (sweeps == budget) return PSORStatus::MaxSweeps;
+        error = partial.empty() ? sweep_gauss_seidel(C, b, g, x) : sweep_red_black(C, b, g, x, partial);
+        stats.sweeps++;
+        stats.error = error;
+        if (sweeps == 0) first = smallest = error;
+        if (best) {
+            double r = residual(C, b, g, x);
+            if (r < *best_residual) {
+                std::copy(x.begin(), x.end(), best->begin());
+                *best_residual = r;
+            }
+        }
+        if (!std::isfinite(error) || error > settings_.divergence * smallest) return PSORStatus::Diverged;
+        smallest = std::min(smallest, error);
+    }
+    return PSORStatus::Converged;
+}
+
+/**
+ * @brief Solves the complementarity problem, starting from the values in `x`.
+ *
+ * Sweeps are repeated until the norm of the update drops to the tolerance, for at most
+ * `PSORSettings::max_sweeps` sweeps. With `Spectral` the relaxation is set from `jacobi_radius`
+ * on the first call and kept for the following ones. With `Tuned` the first calls probe the
+ * relaxation between 1 and that value (see `search`).
+ *
+ * On divergence the initial guess is restored and the remaining budget is spent with \( w = 1 \),
+ * which is then kept for the following calls. The returned status is the one of that restart; if it
+ * diverges too, `x` receives the iterate with the smallest `residual` among the initial guess and
+ * the iterates of the restart.
+ *
+ * @param C Tridiagonal matrix of the system.
+ * @param b Right-hand side.
+ * @param g Lower obstacle (the exercise value).
+ * @param x Initial guess, overwritten with the solution.
+ * @return Convergence statistics of the solve.
+ */
+PSORStats ProjectedSOR::solve(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x) {
+    size_t n = x.size();
+    bool red_black = ordering(n) == PSOROrdering::RedBlack;
+    size_t chunks = red_black ? std::max<size_t>(1, std::min(ThreadPool::global().size(), n / 2 / RED_BLACK_GRAIN)) : 0;
+    ScratchVector partial(chunks);
+
+    if (settings_.omega != PSOROmega::Fixed && !tuned_ && stage_ == 0) {
+        double bound = optimal_omega(jacobi_radius(C));
+        if (settings_.omega == PSOROmega::Spectral) {
+            omega_ = bound;
+            tuned_ = true;
+        }
+        else {
+            lo_ = 1.0;
+            hi_ = bound;
+            c_ = hi_ - GOLDEN * (hi_ - lo_);
+            d_ = lo_ + GOLDEN * (hi_ - lo_);
+            probe_c_ = true;
+        }
+    }
+    if (settings_.omega == PSOROmega::Tuned && !tuned_) {
+        omega_ = probe_c_ ? c_ : d_;
+    }
+
+    ScratchVector start(x);
+    PSORStats stats(0, 0, omega_);
+    double first = 0;
+    stats.status = iterate(C, b, g, x, partial, settings_.max_sweeps, stats, first);
+
+    if (stats.status == PSORStatus::Diverged) {
+        std::copy(start.begin(), start.end(), x.begin());
+        omega_ = stats.omega = 1.0;
+        tuned_ = true;
+        ScratchVector best(start);
+        double best_residual = residual(C, b, g, start);
+        stats.status = iterate(C, b, g, x, partial, settings_.max_sweeps - stats.sweeps, stats, first, &best, &best_residual);
+        if (stats.status == PSORStatus::Diverged) {
+            std::copy(best.begin(), best.end(), x.begin());
+        }
+        return stats;
+    }
+
+    if (settings_.omega == PSOROmega::Tuned && !tuned_ && stats.sweeps > 2 && stats.error > 0) {
+        search(std::log(stats.error / first) / (stats.sweeps - 1));
+    }
+
+    return stats;
+}
\ No newline at end of file
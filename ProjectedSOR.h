@@ -0,0 +1,200 @@
+/**
+ * @file ProjectedSOR.h
+ * @brief Projected successive over-relaxation for the linear complementarity problems of American options.
+ */
+
+#pragma once
+
+#include "Arena.h"
+#include "Tridiag.h"
+
+/**
+ * @brief Order in which the nodes are relaxed during a PSOR sweep.
+ */
+enum class PSOROrdering {
+    Auto,        ///< Gauss-Seidel below `PSORSettings::parallel_threshold` nodes, red-black above.
+    GaussSeidel, ///< Natural ordering, node \( i \) uses the new value of node \( i - 1 \).
+    RedBlack     ///< Even nodes first, then odd nodes; each half-sweep is parallel.
+};
+
+/**
+ * @brief How the relaxation parameter of the PSOR sweeps is chosen.
+ */
+enum class PSOROmega {
+    Fixed,    ///< Always use `PSORSettings::w`.
+    Spectral, ///< Optimal value from the spectral radius of the Jacobi iteration, estimated once per pricing.
+    Tuned     ///< Golden-section search between 1 and the `Spectral` value on the convergence rates of the first time steps.
+};
+
+/**
+ * @brief Outcome of a projected SOR solve.
+ */
+enum class PSORStatus {
+    Converged, ///< The norm of the update reached the tolerance, possibly after a restart with \( w = 1 \).
+    MaxSweeps, ///< The sweep budget was exhausted before reaching the tolerance.
+    Diverged   ///< The updates grew or became non-finite, again after the restart with \( w = 1 \).
+};
+
+/**
+ * @brief Convergence statistics of one projected SOR solve.
+ */
+struct PSORStats {
+    size_t sweeps;     ///< Number of sweeps performed, the restart after a divergence included.
+    double error;      ///< Norm of the update of the last sweep.
+    double omega;      ///< Relaxation parameter of the last sweep.
+    PSORStatus status; ///< Outcome of the solve.
+
+    /**
+     * @brief Constructs the statistics of a solve.
+     * @param sweeps Number of sweeps.
+     * @param error Norm of the last update.
+     * @param omega Relaxation parameter.
+     * @param status Outcome of the solve.
+     */
+    PSORStats(size_t sweeps = 0, double error = 0, double omega = 0, PSORStatus status = PSORStatus::Converged)
+        : sweeps(sweeps), error(error), omega(omega), status(status) {}
+};
+
+/**
+ * @brief Parameters of the projected SOR solver.
+ */
+struct PSORSettings {
+    double tol;                ///< Convergence tolerance on the norm of the update of a sweep.
+    double w;                  ///< Relaxation parameter of the `Fixed` mode, also the baseline for the savings report.
+    PSOROrdering ordering;     ///< Ordering of the sweeps.
+    size_t parallel_threshold; ///< Number of nodes from which `Auto` switches to the red-black ordering.
+    PSOROmega omega;           ///< Selection of the relaxation parameter.
+    bool extrapolate;          ///< Start each time step from the linear extrapolation of the two previous levels.
+    size_t max_sweeps;         ///< Maximum number of sweeps per system.
+    double divergence;         ///< Growth of the update norm over its smallest value that is treated as a divergence.
+
+    /**
+     * @brief Constructs the solver parameters.
+     * @param tol Convergence tolerance.
+     * @param w Relaxation parameter.
+     * @param ordering Ordering of the sweeps.
+     * @param parallel_threshold Number of nodes from which `Auto` switches to the red-black ordering.
+     * @param omega Selection of the relaxation parameter.
+     * @param extrapolate Whether to extrapolate the initial guess of each time step.
+     * @param max_sweeps Maximum number of sweeps per system.
+     * @param divergence Growth factor of the update norm treated as a divergence.
+     */
+    explicit PSORSettings(double tol = 1e-12, double w = 1.2, PSOROrdering ordering = PSOROrdering::Auto, size_t parallel_threshold = 10000,
+        PSOROmega omega = PSOROmega::Tuned, bool extrapolate = true, size_t max_sweeps = 10000, double divergence = 1e4)
+        : tol(tol), w(w), ordering(ordering), parallel_threshold(parallel_threshold), omega(omega), extrapolate(extrapolate),
+        max_sweeps(max_sweeps), divergence(divergence) {}
+
+    /**
+     * @brief Returns the fixed-omega settings used as the reference for the iteration savings.
+     * @return Same tolerance, relaxation and ordering, with a fixed omega and no extrapolation.
+     */
+    PSORSettings baseline() const {
+        return PSORSettings(tol, w, ordering, parallel_threshold, PSOROmega::Fixed, false, max_sweeps, divergence);
+    }
+};
+
+/**
+ * @class ProjectedSOR
+ * @brief Solves \( C x = b \) subject to \( x \geq g \) by projected SOR.
+ *
+ * Each relaxation step updates
+ * \[
+ * x_i \leftarrow \max\left(g_i, x_i + \frac{w}{C_{ii}} \left(b_i - C_{i,i-1} x_{i-1} - C_{ii} x_i - C_{i,i+1} x_{i+1}\right)\right)
+ * \]
+ * until the Euclidean norm of the update of a full sweep falls below the tolerance.
+ *
+ * With the red-black ordering the even nodes only depend on odd ones and vice versa, so each
+ * half-sweep is a data-parallel loop split across `ThreadPool::global()`. Both orderings converge
+ * to the same solution of the complementarity problem.
+ *
+ * The relaxation parameter is state of the solver: with `Spectral` it is computed on the first
+ * system and reused for the next ones, with `Tuned` it is searched over the first systems, so one
+ * solver should be used for all the time steps of a pricing.
+ *
+ * The asymptotic optimum of `Spectral` is the right choice when each system needs many sweeps
+ * (large time steps, \( \rho_J \to 1 \)); with warm starts and few sweeps per step a smaller value
+ * is faster, which `Tuned` finds from the observed decay of the updates.
+ *
+ * A solve never performs more than `PSORSettings::max_sweeps` sweeps. If the norm of the update
+ * becomes non-finite or grows by `PSORSettings::divergence` over its smallest value, the initial
+ * guess is restored and the system is solved again with \( w = 1 \) (projected Gauss-Seidel,
+ * which converges for the diagonally dominant matrices of the scheme); the following systems keep
+ * \( w = 1 \). The status of the solve is the one of that restart, and if the restart diverges as
+ * well the solution is the iterate with the smallest complementarity residual among the initial
+ * guess and the iterates of the restart. The outcome is reported in the returned `PSORStats`
+ * rather than thrown.
+ */
+class ProjectedSOR {
+
+    PSORSettings settings_;
+    double omega_;
+    bool tuned_;
+    double lo_, hi_, c_, d_;
+    double fc_, fd_;
+    bool probe_c_;
+    int stage_;
+
+    double sweep_gauss_seidel(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x) const;
+    double sweep_red_black(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, ScratchVector& partial) const;
+    double relax_colour(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, size_t lo, size_t hi) const;
+    void search(double rate);
+    PSORStatus iterate(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x, ScratchVector& partial,
+        size_t budget, PSORStats& stats, double& first, ScratchVector* best = nullptr, double* best_residual = nullptr) const;
+    static double residual(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, const ScratchVector& x);
+
+public:
+    /**
+     * @brief Constructs the solver.
+     * @param settings Solver parameters.
+     */
+    explicit ProjectedSOR(const PSORSettings& settings = PSORSettings());
+
+    /**
+     * @brief Estimates the spectral radius of the Jacobi iteration matrix of \( C \).
+     *
+     * The Jacobi matrix \( J = I - \text{diag}(C)^{-1} C \) is tridiagonal with zero diagonal; its
+     * spectral radius is bounded by the largest eigenvalue of the symmetric matrix with
+     * off-diagonal entries \( \sqrt{|J_{i+1,i} J_{i,i+1}|} \) (equal to it when the products are positive),
+     * which is located by Sturm-sequence bisection.
+     *
+     * @param C Tridiagonal matrix of the system.
+     * @return Spectral radius of the Jacobi iteration.
+     */
+    static double jacobi_radius(const Tridiag& C);
+
+    /**
+     * @brief Returns the optimal SOR relaxation for a given Jacobi spectral radius.
+     * @param rho Spectral radius of the Jacobi iteration.
+     * @return \( 2 / (1 + \sqrt{1 - \rho^2}) \).
+     */
+    static double optimal_omega(double rho);
+
+    /**
+     * @brief Returns the relaxation parameter currently used by the sweeps.
+     * @return Relaxation parameter.
+     */
+    double omega() const { return omega_; }
+
+    /**
+     * @brief Returns the solver parameters.
+     * @return Solver parameters.
+     */
+    const PSORSettings& settings() const { return settings_; }
+
+    /**
+     * @brief Tells which ordering is used for a system of the given size.
+     * @param n Number of unknowns.
+     * @return `GaussSeidel` or `RedBlack`.
+     */
+    PSOROrdering ordering(size_t n) const;
+
+    /**
+     * @brief Solves the complementarity problem, starting from the values in `x`.
+     * @param C Tridiagonal matrix of the system.
+     * @param b Right-hand side.
+     * @param g Lower obstacle (the exercise value).
+     * @param x Initial guess, overwritten with the solution.
+     * @return Convergence statistics of the solve.
+     */
+    PSORStats solve(const Tridiag& C, const ScratchVector& b, const ScratchVector& g, ScratchVector& x);
+};
\ No newline at end of file
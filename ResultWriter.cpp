@@ -0,0 +1,239 @@
+/**
+ * @file ResultWriter.cpp
+ * @brief Contains the methods of the streaming result writer.
+ */
+
+#include "ResultWriter.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[8] = { 'C', 'N', 'R', 'E', 'S', 'U', 'L', 'T' };
+
+/**
+ * @brief Number of empty polls the writer thread spins through before it starts sleeping.
+ */
+const size_t SPIN = 64;
+
+/**
+ * @brief Longest line of the CSV output: an identifier and six numbers of 17 significant digits.
+ */
+const size_t LINE = 200;
+
+}
+
+/**
+ * @brief Opens the output and starts the writer thread.
+ * @param path Path of the file, overwritten; "-" writes to the standard output.
+ * @param format Binary or CSV output.
+ * @param capacity Number of results the queue holds, rounded up to a power of 2.
+ */
+ResultWriter::ResultWriter(const std::string& path, ResultFormat format, size_t capacity)
+    : format_(format), file_(nullptr), owned_(path != "-"), mask_(0), tail_(0), head_(0), closing_(false), closed_(false),
+    ids_(BLOCK), filled_(0), rows_(0) {
+    size_t slots = 2;
+    while (slots < capacity) slots *= 2;
+    slots_.reset(new Slot[slots]);
+    for (size_t ii = 0; ii < slots; ii++) {
+        slots_[ii].sequence.store(ii, std::memory_order_relaxed);
+    }
+    mask_ = slots - 1;
+    for (auto& column : columns_) {
+        column.resize(BLOCK);
+    }
+
+    file_ = owned_ ? std::fopen(path.c_str(), "wb") : stdout;
+    if (!file_) throw InvalidResultFile(-1);
+    if (owned_) std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+    try {
+        write_header();
+    }
+    catch (...) {
+        if (owned_) std::fclose(file_);
+        throw;
+    }
+    writer_ = std::thread([this] {
+        drain();
+        finish();
+    });
+}
+
+/**
+ * @brief Closes the writer, ignoring write errors.
+ */
+ResultWriter::~ResultWriter() {
+    try {
+        close();
+    }
+    catch (...) {
+    }
+}
+
+/**
+ * @brief Queues one result; safe to call from any number of threads.
+ *
+ * A slot is free for position \( p \) when its sequence number equals \( p \): the producer claims
+ * the position by advancing the tail, fills the slot and publishes it by setting the sequence to
+ * \( p + 1 \). A sequence behind \( p \) means the queue is full.
+ *
+ * @param result Price and Greeks of a trade.
+ */
+void ResultWriter::push(const TradeResult& result) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & mask_];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.value = result;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        }
+        else if (diff < 0) {
+            std::this_thread::yield();
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+        else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Takes the oldest published result off the queue; called by the writer thread only.
+ * @param result Receives the result.
+ * @return Whether a result was available.
+ */
+bool ResultWriter::pop(TradeResult& result) {
+    Slot& slot = slots_[head_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return false;
+    result = slot.value;
+    slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    head_++;
+    return true;
+}
+
+/**
+ * @brief Moves results from the queue to the column buffers until the writer is closed.
+ *
+ * The closing flag is read before the queue is drained, so once it is seen set and the queue found
+ * empty every result pushed before `close` has been taken. While the queue stays empty the thread
+ * yields, then sleeps in short intervals.
+ */
+void ResultWriter::drain() {
+    TradeResult result;
+    size_t idle = 0;
+    for (;;) {
+        bool closing = closing_.load(std::memory_order_acquire);
+        size_t taken = 0;
+        while (pop(result)) {
+            ids_[filled_] = result.id;
+            columns_[0][filled_] = result.price;
+            columns_[1][filled_] = result.delta;
+            columns_[2][filled_] = result.gamma;
+            columns_[3][filled_] = result.theta;
+            columns_[4][filled_] = result.vega;
+            columns_[5][filled_] = result.rho;
+            if (++filled_ == BLOCK) write_block();
+            taken++;
+        }
+        if (taken > 0) {
+            idle = 0;
+            continue;
+        }
+        if (closing) break;
+        if (++idle < SPIN) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+/**
+ * @brief Writes the binary header or the CSV header line.
+ */
+void ResultWriter::write_header() {
+    if (format_ == ResultFormat::Binary) {
+        ResultFileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = ResultFileHeader::VERSION;
+        header.columns = 7;
+        header.rows = 0;
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1) throw InvalidResultFile(-1);
+    }
+    else {
+        if (std::fputs("id,price,delta,gamma,theta,vega,rho\n", file_) < 0) throw InvalidResultFile(-1);
+    }
+}
+
+/**
+ * @brief Writes the rows of the column buffers as one block and empties them.
+ *
+ * A binary block is written as its row count and seven `fwrite` of whole columns; a CSV block is
+ * formatted into one buffer and written at once. After a write error the rows are dropped, so the
+ * queue keeps draining and producers never block.
+ */
+void ResultWriter::write_block() {
+    size_t n = filled_;
+    filled_ = 0;
+    if (error_ || n == 0) return;
+    try {
+        bool ok = true;
+        if (format_ == ResultFormat::Binary) {
+            std::uint64_t count = n;
+            ok = std::fwrite(&count, sizeof(count), 1, file_) == 1 && std::fwrite(ids_.data(), sizeof(std::uint64_t), n, file_) == n;
+            for (auto& column : columns_) {
+                ok = ok && std::fwrite(column.data(), sizeof(double), n, file_) == n;
+            }
+        }
+        else {
+            text_.resize(n * LINE);
+            char* p = &text_[0];
+            for (size_t ii = 0; ii < n; ii++) {
+                p += std::snprintf(p, LINE, "%llu,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n", static_cast<unsigned long long>(ids_[ii]),
+                    columns_[0][ii], columns_[1][ii], columns_[2][ii], columns_[3][ii], columns_[4][ii], columns_[5][ii]);
+            }
+            size_t bytes = p - text_.data();
+            ok = std::fwrite(text_.data(), 1, bytes, file_) == bytes;
+        }
+        if (!ok) throw InvalidResultFile(static_cast<double>(rows_.load()));
+        rows_.fetch_add(n);
+    }
+    catch (...) {
+        error_ = std::current_exception();
+    }
+}
+
+/**
+ * @brief Writes the last block, completes the binary header and closes the output.
+ */
+void ResultWriter::finish() {
+    write_block();
+    if (!error_ && format_ == ResultFormat::Binary && owned_ && std::fseek(file_, offsetof(ResultFileHeader, rows), SEEK_SET) == 0) {
+        std::uint64_t rows = rows_.load();
+        if (std::fwrite(&rows, sizeof(rows), 1, file_) != 1) error_ = std::make_exception_ptr(InvalidResultFile(static_cast<double>(rows)));
+    }
+    bool flushed = owned_ ? std::fclose(file_) == 0 : std::fflush(file_) == 0;
+    if (!flushed && !error_) error_ = std::make_exception_ptr(InvalidResultFile(static_cast<double>(rows_.load())));
+}
+
+/**
+ * @brief Writes every queued result and closes the output.
+ *
+ * Rethrows the first write error.
+ */
+void ResultWriter::close() {
+    if (closed_) return;
+    closed_ = true;
+    closing_.store(true, std::memory_order_release);
+    writer_.join();
+    if (error_) std::rethrow_exception(error_);
+}
\ No newline at end of file
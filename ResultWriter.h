@@ -0,0 +1,146 @@
+/**
+ * @file ResultWriter.h
+ * @brief Streaming writer of prices and Greeks, fed through a lock-free queue and flushed by a background thread.
+ */
+
+#pragma once
+
+#include "OptionExceptions.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Price and Greeks of one trade.
+ */
+struct TradeResult {
+    std::uint64_t id; ///< Identifier of the trade.
+    double price;     ///< Price of the option.
+    double delta;     ///< Delta at the initial spot.
+    double gamma;     ///< Gamma at the initial spot.
+    double theta;     ///< Theta.
+    double vega;      ///< Vega.
+    double rho;       ///< Rho.
+};
+
+/**
+ * @brief Output format of a `ResultWriter`.
+ */
+enum class ResultFormat {
+    Binary, ///< Header, then blocks of rows stored column by column.
+    CSV     ///< Header line, then one line per row.
+};
+
+/**
+ * @brief Header of a binary result file.
+ *
+ * It is followed by blocks, each a `std::uint64_t` row count \( n \) and the seven columns of the
+ * block in the order of `TradeResult`: \( n \) identifiers, then \( n \) prices, deltas, gammas,
+ * thetas, vegas and rhos. Values are stored in the byte order of the host.
+ */
+struct ResultFileHeader {
+    char magic[8];         ///< "CNRESULT", without a null byte.
+    std::uint32_t version; ///< Version of the format, `ResultFileHeader::VERSION`.
+    std::uint32_t columns; ///< Number of columns, 7.
+    std::uint64_t rows;    ///< Total number of rows; 0 when the output cannot seek back to the header.
+
+    /**
+     * @brief Current version of the format.
+     */
+    static const std::uint32_t VERSION = 1;
+};
+
+static_assert(sizeof(ResultFileHeader) == 24, "ResultFileHeader must have no padding");
+
+/**
+ * @class ResultWriter
+ * @brief Collects the results of concurrent pricing workers and writes them from a background thread.
+ *
+ * Workers hand their results to `push`, which stores them in a bounded multi-producer queue without
+ * taking a lock: a producer claims a slot with one compare-and-swap and publishes it through the
+ * slot's sequence number. A dedicated thread drains the queue into column buffers of `BLOCK` rows
+ * and writes a block whenever it fills up, so formatting and I/O overlap the pricing instead of
+ * following it. When the queue is full, producers wait for the writer to catch up.
+ *
+ * Rows are written in the order they are pushed, which is not the order of the trades when several
+ * workers push; each row carries the identifier of its trade. `close` drains the queue, writes the
+ * last block and reports any write error; it is also called by the destructor, which swallows the
+ * error.
+ */
+class ResultWriter {
+    struct Slot {
+        std::atomic<size_t> sequence;
+        TradeResult value;
+    };
+
+    ResultFormat format_;
+    std::FILE* file_;
+    bool owned_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_;
+    alignas(64) size_t head_;
+    std::atomic<bool> closing_;
+    bool closed_;
+    std::vector<std::uint64_t> ids_;
+    std::vector<double> columns_[6];
+    std::vector<char> text_;
+    size_t filled_;
+    std::atomic<size_t> rows_;
+    std::exception_ptr error_;
+    std::thread writer_;
+
+    bool pop(TradeResult& result);
+    void drain();
+    void write_header();
+    void write_block();
+    void finish();
+
+public:
+    /**
+     * @brief Number of rows of a column block.
+     */
+    static const size_t BLOCK = 4096;
+
+    /**
+     * @brief Opens the output and starts the writer thread.
+     * @param path Path of the file, overwritten; "-" writes to the standard output.
+     * @param format Binary or CSV output.
+     * @param capacity Number of results the queue holds, rounded up to a power of 2.
+     */
+    ResultWriter(const std::string& path, ResultFormat format, size_t capacity = 1 << 16);
+
+    /**
+     * @brief Closes the writer, ignoring write errors.
+     */
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * @brief Queues one result; safe to call from any number of threads.
+     * @param result Price and Greeks of a trade.
+     */
+    void push(const TradeResult& result);
+
+    /**
+     * @brief Writes every queued result and closes the output.
+     *
+     * No result may be pushed during or after the call. Rethrows the first write error.
+     */
+    void close();
+
+    /**
+     * @brief Returns the number of rows written so far.
+     * @return Rows written; final once `close` has returned.
+     */
+    size_t rows() const { return rows_.load(); }
+};
\ No newline at end of file
@@ -0,0 +1,198 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Contains the methods of the persistent worker pool.
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Set on pool workers, so that batches submitted from a task run serially.
+     */
+    thread_local bool in_pool = false;
+
+    /**
+     * @brief Marks the current thread as running tasks for as long as it lives, restoring the previous state.
+     */
+    struct PoolScope {
+        bool saved;
+        PoolScope() : saved(in_pool) { in_pool = true; }
+        ~PoolScope() { in_pool = saved; }
+    };
+
+    /**
+     * @brief Number of polls of the batch counter before a worker goes to sleep.
+     */
+    const int SPIN = 4096;
+
+    /**
+     * @brief Layout of the pool state: generation in the high 32 bits, open seats in bits 16 to 31,
+     * running workers in the low 16 bits.
+     */
+    const std::uint64_t SEAT = std::uint64_t(1) << 16;
+    const std::uint64_t RUNNING = SEAT - 1;
+    const std::uint64_t SEATS = (SEAT - 1) << 16;
+
+    std::uint64_t generation(std::uint64_t state) { return state >> 32; }
+}
+
+/**
+ * @brief Starts the worker threads.
+ * @param threads Total concurrency, the submitting thread included; 0 uses the hardware concurrency.
+ */
+ThreadPool::ThreadPool(unsigned int threads)
+    : task_(nullptr), tasks_(0), next_(0), state_(0), stop_(false) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int ii = 1; ii < threads; ii++) {
+        workers_.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Pulls tasks of the current batch until none is left.
+ */
+void ThreadPool::run_tasks() {
+    for (size_t ii = next_.fetch_add(1); ii < tasks_; ii = next_.fetch_add(1)) {
+        try {
+            (*task_)(ii);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ *
+ * Waits for a new batch (spinning first, then sleeping) and takes one of its seats if any is left:
+ * the seat is taken with a compare-and-swap that also checks the generation, so a worker that
+ * wakes up after its batch is over never touches the next one. A seated worker works on the
+ * batch and signals its completion; the others go back to waiting.
+ */
+void ThreadPool::work() {
+    in_pool = true;
+    std::uint64_t seen = 0;
+    for (;;) {
+        std::uint64_t state = state_.load(std::memory_order_acquire);
+        for (int spin = 0; generation(state) == seen && spin < SPIN && !stop_; spin++) {
+            std::this_thread::yield();
+            state = state_.load(std::memory_order_acquire);
+        }
+        if (generation(state) == seen) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation(state_.load()) != seen; });
+            state = state_.load(std::memory_order_acquire);
+        }
+        if (stop_) return;
+
+        seen = generation(state);
+        bool seated = false;
+        while (!seated && generation(state) == seen && (state & SEATS) != 0) {
+            seated = state_.compare_exchange_weak(state, state - SEAT + 1, std::memory_order_acq_rel);
+        }
+        if (!seated) continue;
+        run_tasks();
+        state_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Runs a batch of tasks and waits for its completion.
+ *
+ * Falls back to a serial loop for single-task batches, for pools without workers and
+ * when called from inside a task, whether that task runs on a worker or on the submitting thread.
+ *
+ * Only the workers that take one of the batch's seats are waited for. Once the submitting thread
+ * has run out of tasks it closes the seats left, so no worker joins a batch that is ending.
+ *
+ * @param tasks Number of tasks.
+ * @param task Function called with each task index.
+ */
+void ThreadPool::run(size_t tasks, const std::function<void(size_t)>& task) {
+    if (tasks <= 1 || workers_.empty() || in_pool) {
+        for (size_t ii = 0; ii < tasks; ii++) {
+            task(ii);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submit_);
+    task_ = &task;
+    tasks_ = tasks;
+    error_ = nullptr;
+    next_ = 0;
+    size_t seats = std::min(tasks - 1, workers_.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t next = generation(state_.load()) + 1;
+        state_.store((next << 32) | (seats << 16), std::memory_order_release);
+    }
+    if (seats == workers_.size()) {
+        wake_.notify_all();
+    }
+    else {
+        for (size_t ii = 0; ii < seats; ii++) {
+            wake_.notify_one();
+        }
+    }
+
+    {
+        // The submitting thread is a worker of this batch: its own nested submissions run serially.
+        PoolScope scope;
+        run_tasks();
+    }
+    std::uint64_t state = state_.load(std::memory_order_acquire);
+    while (!state_.compare_exchange_weak(state, state & ~SEATS, std::memory_order_acq_rel)) {
+    }
+    while ((state_.load(std::memory_order_acquire) & RUNNING) != 0) {
+        std::this_thread::yield();
+    }
+
+    if (error_) std::rethrow_exception(error_);
+}
+
+/**
+ * @brief Splits a range into contiguous chunks processed in parallel.
+ *
+ * The range is divided into at most `size()` chunks of at least `grain` indices.
+ *
+ * @param begin First index of the range.
+ * @param end One past the last index of the range.
+ * @param body Function called with the bounds `[lo, hi)` of each chunk.
+ * @param grain Minimum number of indices per chunk.
+ */
+void ThreadPool::parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body, size_t grain) {
+    if (end <= begin) return;
+    size_t n = end - begin;
+    size_t chunks = std::min(size(), std::max<size_t>(1, n / std::max<size_t>(1, grain)));
+    run(chunks, [&](size_t ii) {
+        body(begin + n * ii / chunks, begin + n * (ii + 1) / chunks);
+    });
+}
+
+/**
+ * @brief Returns the process-wide pool, sized to the hardware concurrency.
+ * @return Shared thread pool.
+ */
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file ThreadPool.h
+ * @brief Persistent pool of worker threads used to split numerical loops across cores.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads executing batches of indexed tasks.
+ *
+ * A batch is a number of tasks `0, ..., n - 1` and a function called once per task; the calling
+ * thread takes part in the work and returns when every task is done. Workers spin briefly before
+ * sleeping, so back-to-back batches (such as the half-sweeps of an iterative solver) are dispatched
+ * without a system call.
+ *
+ * A batch of \( n \) tasks opens \( \min(n - 1, \text{workers}) \) seats: only the workers taking a seat
+ * join it and only they are waited for, so a batch of two tasks costs the same on any pool size.
+ * The generation of the batch, its open seats and its running workers share one atomic word, so a
+ * worker that wakes up late can only take a seat of the batch it was woken for.
+ *
+ * Batches submitted from inside a task run serially on the thread running that task, a worker or
+ * the submitting thread alike, so nested parallel code never deadlocks.
+ */
+class ThreadPool {
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    const std::function<void(size_t)>* task_;
+    size_t tasks_;
+    std::atomic<size_t> next_;
+    std::atomic<std::uint64_t> state_;
+    std::atomic<bool> stop_;
+    std::exception_ptr error_;
+
+    void work();
+    void run_tasks();
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Total concurrency, the submitting thread included; 0 uses the hardware concurrency.
+     */
+    explicit ThreadPool(unsigned int threads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Returns the number of threads working on a batch, the submitting thread included.
+     * @return Concurrency of the pool.
+     */
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Runs a batch of tasks and waits for its completion.
+     *
+     * The first exception thrown by a task is rethrown to the caller once the batch is over.
+     *
+     * @param tasks Number of tasks.
+     * @param task Function called with each task index.
+     */
+    void run(size_t tasks, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Splits a range into contiguous chunks processed in parallel.
+     * @param begin First index of the range.
+     * @param end One past the last index of the range.
+     * @param body Function called with the bounds `[lo, hi)` of each chunk.
+     * @param grain Minimum number of indices per chunk.
+     */
+    void parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body, size_t grain = 1);
+
+    /**
+     * @brief Returns the process-wide pool, sized to the hardware concurrency.
+     * @return Shared thread pool.
+     */
+    static ThreadPool& global();
+};
\ No newline at end of file
@@ -0,0 +1,341 @@
+/**
+ * @file TradeFile.cpp
+ * @brief Contains the binary trade format, its CSV importer and the memory-mapped loader.
+ */
+
+#include "TradeFile.h"
+#include "Option.h"
+#include "ThreadPool.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = { 'C', 'N', 'T', 'R', 'A', 'D', 'E', '\0' };
+
+/**
+ * @brief Number of records buffered by the CSV importer before a write.
+ */
+const size_t BLOCK = 4096;
+
+/**
+ * @brief Builds the header of a binary trade file in the current format.
+ * @param count Number of records that follow the header.
+ * @return Header with the magic string, the version and the record size.
+ */
+TradeFileHeader make_header(size_t count) {
+    TradeFileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = TradeFileHeader::VERSION;
+    header.record_size = sizeof(TradeRecord);
+    header.count = count;
+    header.reserved = 0;
+    return header;
+}
+
+/**
+ * @brief Maps a whole file read-only.
+ * @param path Path of the file.
+ * @param bytes Receives the size of the file.
+ * @return Base address of the mapping.
+ */
+void* map_file(const std::string& path, size_t& bytes) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw InvalidTradeFile(-1);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw InvalidTradeFile(-1);
+    }
+    bytes = static_cast<size_t>(size.QuadPart);
+    if (bytes < sizeof(TradeFileHeader)) {
+        CloseHandle(file);
+        throw InvalidTradeFile(static_cast<double>(bytes));
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) throw InvalidTradeFile(-1);
+    // The view keeps the mapping object alive.
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!base) throw InvalidTradeFile(-1);
+    return base;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw InvalidTradeFile(-1);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw InvalidTradeFile(-1);
+    }
+    bytes = static_cast<size_t>(st.st_size);
+    if (bytes < sizeof(TradeFileHeader)) {
+        ::close(fd);
+        throw InvalidTradeFile(static_cast<double>(bytes));
+    }
+    // The mapping holds its own reference to the file.
+    void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) throw InvalidTradeFile(-1);
+    ::madvise(base, bytes, MADV_SEQUENTIAL);
+    return base;
+#endif
+}
+
+/**
+ * @brief Unmaps a file mapped by `map_file`.
+ * @param base Base address of the mapping.
+ * @param bytes Size of the mapping.
+ */
+void unmap_file(void* base, size_t bytes) {
+#ifdef _WIN32
+    (void)bytes;
+    UnmapViewOfFile(base);
+#else
+    ::munmap(base, bytes);
+#endif
+}
+
+/**
+ * @brief Parses one field of a CSV line.
+ * @param p Start of the field, moved past its separator.
+ * @param last Whether the field ends the line.
+ * @param value Receives the value.
+ * @return Whether the field is a number followed by the expected separator.
+ */
+template <typename T>
+bool parse_field(const char*& p, bool last, T& value) {
+    char* end;
+    errno = 0;
+    if (std::is_floating_point<T>::value) {
+        value = static_cast<T>(std::strtod(p, &end));
+    }
+    else if (std::is_signed<T>::value) {
+        value = static_cast<T>(std::strtol(p, &end, 10));
+    }
+    else {
+        value = static_cast<T>(std::strtoull(p, &end, 10));
+    }
+    if (end == p || errno == ERANGE) return false;
+    while (*end == ' ' || *end == '\t') end++;
+    if (last) {
+        if (*end == '\r') end++;
+        return *end == '\0';
+    }
+    if (*end != ',') return false;
+    p = end + 1;
+    return true;
+}
+
+/**
+ * @brief Parses a data line of a CSV trade file.
+ * @param line Null-terminated line.
+ * @param trade Receives the record.
+ * @return Whether the line holds the eleven fields of a record.
+ */
+bool parse_line(const char* line, TradeRecord& trade) {
+    const char* p = line;
+    return parse_field(p, false, trade.id)
+        && parse_field(p, false, trade.contract_type)
+        && parse_field(p, false, trade.exercise_type)
+        && parse_field(p, false, trade.T)
+        && parse_field(p, false, trade.K)
+        && parse_field(p, false, trade.T0)
+        && parse_field(p, false, trade.S0)
+        && parse_field(p, false, trade.volatility)
+        && parse_field(p, false, trade.S_max)
+        && parse_field(p, false, trade.time_mesh)
+        && parse_field(p, true, trade.spot_mesh);
+}
+
+}
+
+/**
+ * @brief Maps a binary trade file.
+ *
+ * The header must carry the magic string, the current version and the record size, and the file
+ * must hold exactly the number of records it declares.
+ *
+ * @param path Path of the file.
+ */
+TradeFile::TradeFile(const std::string& path) : map_(nullptr), bytes_(0), records_(nullptr), count_(0) {
+    map_ = map_file(path, bytes_);
+    TradeFileHeader header;
+    std::memcpy(&header, map_, sizeof(header));
+    size_t payload = bytes_ - sizeof(header);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != TradeFileHeader::VERSION
+        || header.record_size != sizeof(TradeRecord) || payload % sizeof(TradeRecord) != 0 || payload / sizeof(TradeRecord) != header.count) {
+        double bytes = static_cast<double>(bytes_);
+        unmap();
+        throw InvalidTradeFile(bytes);
+    }
+    records_ = reinterpret_cast<const TradeRecord*>(static_cast<const char*>(map_) + sizeof(header));
+    count_ = static_cast<size_t>(header.count);
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+TradeFile::~TradeFile() {
+    unmap();
+}
+
+/**
+ * @brief Takes over the mapping of another file.
+ * @param other File left empty.
+ */
+TradeFile::TradeFile(TradeFile&& other) noexcept
+    : map_(other.map_), bytes_(other.bytes_), records_(other.records_), count_(other.count_) {
+    other.map_ = nullptr;
+    other.bytes_ = 0;
+    other.records_ = nullptr;
+    other.count_ = 0;
+}
+
+/**
+ * @brief Releases the current mapping and takes over the mapping of another file.
+ * @param other File left empty.
+ * @return This file.
+ */
+TradeFile& TradeFile::operator=(TradeFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(map_, other.map_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(records_, other.records_);
+        std::swap(count_, other.count_);
+    }
+    return *this;
+}
+
+/**
+ * @brief Releases the mapping, if any.
+ */
+void TradeFile::unmap() {
+    if (map_) unmap_file(map_, bytes_);
+    map_ = nullptr;
+    bytes_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+/**
+ * @brief Writes trades to a binary trade file.
+ * @param path Path of the file, overwritten.
+ * @param trades First record.
+ * @param count Number of records.
+ */
+void write_trades(const std::string& path, const TradeRecord* trades, size_t count) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw InvalidTradeFile(-1);
+    TradeFileHeader header = make_header(count);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(trades), static_cast<std::streamsize>(count * sizeof(TradeRecord)));
+    if (!out) throw InvalidTradeFile(-1);
+}
+
+/**
+ * @brief Converts a CSV trade file to a binary trade file.
+ *
+ * The header is written first with a count of 0 and rewritten with the final count once every
+ * line has been converted.
+ *
+ * @param csv_path Path of the CSV file.
+ * @param path Path of the binary file, overwritten.
+ * @return Number of records written.
+ */
+size_t import_csv(const std::string& csv_path, const std::string& path) {
+    std::ifstream in(csv_path);
+    if (!in) throw InvalidTradeFile(-1);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw InvalidTradeFile(-1);
+
+    TradeFileHeader header = make_header(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<TradeRecord> block(BLOCK);
+    size_t filled = 0;
+    size_t count = 0;
+    size_t line_number = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        line_number++;
+        const char* p = line.c_str();
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '\r' || *p == '#') continue;
+        if (line_number == 1 && std::isalpha(static_cast<unsigned char>(*p))) continue;
+        if (!parse_line(p, block[filled])) throw InvalidTradeFile(static_cast<double>(line_number));
+        if (++filled == BLOCK) {
+            out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(filled * sizeof(TradeRecord)));
+            count += filled;
+            filled = 0;
+        }
+    }
+    out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(filled * sizeof(TradeRecord)));
+    count += filled;
+
+    header.count = count;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) throw InvalidTradeFile(-1);
+    return count;
+}
+
+/**
+ * @brief Prices a batch of trades on a shared rate curve.
+ * @param trades First record, typically `TradeFile::data()`.
+ * @param count Number of records.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @return Price of each trade, in the same order.
+ */
+std::vector<double> price_trades(const TradeRecord* trades, size_t count, const InterestRateHandle& rate_curve) {
+    std::vector<double> prices(count);
+    ThreadPool::global().parallel_for(0, count, [&](size_t lo, size_t hi) {
+        for (size_t ii = lo; ii < hi; ii++) {
+            const TradeRecord& t = trades[ii];
+            Option option(t.contract_type, t.exercise_type, t.T, t.K, t.T0, t.time_mesh, t.spot_mesh, t.S0, rate_curve, t.volatility, PSORSettings(), t.S_max);
+            prices[ii] = option.price();
+        }
+    });
+    return prices;
+}
+
+/**
+ * @brief Prices a batch of trades and streams their prices and Greeks to a writer.
+ * @param trades First record, typically `TradeFile::data()`.
+ * @param count Number of records.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param out Writer receiving one row per trade, in completion order.
+ */
+void price_trades(const TradeRecord* trades, size_t count, const InterestRateHandle& rate_curve, ResultWriter& out) {
+    ThreadPool::global().parallel_for(0, count, [&](size_t lo, size_t hi) {
+        for (size_t ii = lo; ii < hi; ii++) {
+            const TradeRecord& t = trades[ii];
+            Option option(t.contract_type, t.exercise_type, t.T, t.K, t.T0, t.time_mesh, t.spot_mesh, t.S0, rate_curve, t.volatility, PSORSettings(), t.S_max);
+            TradeResult result = { t.id, option.price(), option.delta(t.S0), option.gamma(), option.theta(), option.vega(), option.rho() };
+            out.push(result);
+        }
+    });
+}
\ No newline at end of file
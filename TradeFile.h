@@ -0,0 +1,190 @@
+/**
+ * @file TradeFile.h
+ * @brief Fixed-record binary trade format, its CSV importer and a memory-mapped loader for batch pricing.
+ */
+
+#pragma once
+
+#include "InterestRate.h"
+#include "OptionExceptions.h"
+#include "ResultWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Contract of one trade, stored as a fixed 72-byte record.
+ *
+ * The fields are those of the `Option` constructor on a shared rate curve, with the same
+ * conventions; the record has no padding and no pointer, so a file of records is used in place.
+ */
+struct TradeRecord {
+    std::uint64_t id;           ///< Identifier of the trade.
+    std::int32_t contract_type; ///< 1 for Call, -1 for Put.
+    std::int32_t exercise_type; ///< Exercise type, as in `Option`.
+    double T;                   ///< Maturity of the option.
+    double K;                   ///< Strike price.
+    double T0;                  ///< Initial time.
+    double S0;                  ///< Initial spot price.
+    double volatility;          ///< Volatility of the underlying asset.
+    double S_max;               ///< Upper bound of the spot grid; 0 uses \( 5 S_0 \).
+    std::uint32_t time_mesh;    ///< Number of time steps in the grid.
+    std::uint32_t spot_mesh;    ///< Number of spot steps in the grid.
+};
+
+static_assert(sizeof(TradeRecord) == 72, "TradeRecord must have no padding");
+static_assert(std::is_trivially_copyable<TradeRecord>::value, "TradeRecord must be trivially copyable");
+
+/**
+ * @brief Header of a binary trade file, followed by `count` records.
+ *
+ * Integers are stored in the byte order of the host; a file written on a machine of the other
+ * byte order is rejected by its version field.
+ */
+struct TradeFileHeader {
+    char magic[8];             ///< "CNTRADE" and a null byte.
+    std::uint32_t version;     ///< Version of the format, `TradeFileHeader::VERSION`.
+    std::uint32_t record_size; ///< Size of a record, `sizeof(TradeRecord)`.
+    std::uint64_t count;       ///< Number of records.
+    std::uint64_t reserved;    ///< Zero; keeps the records 8-byte aligned.
+
+    /**
+     * @brief Current version of the format.
+     */
+    static const std::uint32_t VERSION = 1;
+};
+
+static_assert(sizeof(TradeFileHeader) == 32, "TradeFileHeader must have no padding");
+
+/**
+ * @class TradeFile
+ * @brief Read-only view of a binary trade file mapped in memory.
+ *
+ * The file is mapped once and its records are exposed in place as a contiguous array: opening a
+ * file of any size costs one system call and no allocation, and the pages are read by the operating
+ * system on first access. The header is checked on opening; the records themselves are validated by
+ * the pricer that consumes them.
+ *
+ * The object owns the mapping: it can be moved but not copied, and the records stay valid until it
+ * is destroyed.
+ */
+class TradeFile {
+    void* map_;
+    size_t bytes_;
+    const TradeRecord* records_;
+    size_t count_;
+
+    void unmap();
+
+public:
+    /**
+     * @brief Maps a binary trade file.
+     * @param path Path of the file.
+     */
+    explicit TradeFile(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~TradeFile();
+
+    TradeFile(const TradeFile&) = delete;
+    TradeFile& operator=(const TradeFile&) = delete;
+
+    /**
+     * @brief Takes over the mapping of another file.
+     * @param other File left empty.
+     */
+    TradeFile(TradeFile&& other) noexcept;
+
+    /**
+     * @brief Releases the current mapping and takes over the mapping of another file.
+     * @param other File left empty.
+     * @return This file.
+     */
+    TradeFile& operator=(TradeFile&& other) noexcept;
+
+    /**
+     * @brief Returns the records of the file.
+     * @return Pointer to the first record, inside the mapping.
+     */
+    const TradeRecord* data() const { return records_; }
+
+    /**
+     * @brief Returns the number of records.
+     * @return Number of trades in the file.
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Returns one record.
+     * @param i Index of the record.
+     * @return Record inside the mapping.
+     */
+    const TradeRecord& operator[](size_t i) const { return records_[i]; }
+
+    /**
+     * @brief Returns the first record, for range-based loops.
+     * @return Pointer to the first record.
+     */
+    const TradeRecord* begin() const { return records_; }
+
+    /**
+     * @brief Returns one past the last record, for range-based loops.
+     * @return Pointer past the last record.
+     */
+    const TradeRecord* end() const { return records_ + count_; }
+};
+
+/**
+ * @brief Writes trades to a binary trade file.
+ * @param path Path of the file, overwritten.
+ * @param trades First record.
+ * @param count Number of records.
+ */
+void write_trades(const std::string& path, const TradeRecord* trades, size_t count);
+
+/**
+ * @brief Converts a CSV trade file to a binary trade file.
+ *
+ * Each data line holds the fields of a `TradeRecord` in declaration order,
+ * `id,contract_type,exercise_type,T,K,T0,S0,volatility,S_max,time_mesh,spot_mesh`. A first line
+ * starting with a letter is taken as a header; blank lines and lines starting with '#' are skipped.
+ * The lines are parsed in place and the records written in blocks, so the memory used does not
+ * grow with the file.
+ *
+ * @param csv_path Path of the CSV file.
+ * @param path Path of the binary file, overwritten.
+ * @return Number of records written.
+ */
+size_t import_csv(const std::string& csv_path, const std::string& path);
+
+/**
+ * @brief Prices a batch of trades on a shared rate curve.
+ *
+ * The trades are split in contiguous chunks across `ThreadPool::global()`; each one is priced by
+ * an `Option` built from its record.
+ *
+ * @param trades First record, typically `TradeFile::data()`.
+ * @param count Number of records.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @return Price of each trade, in the same order.
+ */
+std::vector<double> price_trades(const TradeRecord* trades, size_t count, const InterestRateHandle& rate_curve);
+
+/**
+ * @brief Prices a batch of trades and streams their prices and Greeks to a writer.
+ *
+ * Each worker of `ThreadPool::global()` pushes the result of a trade as soon as it is priced, so
+ * the writer thread formats and writes while the rest of the batch is being priced. The Greeks are
+ * those of `Option`, the delta at the initial spot.
+ *
+ * @param trades First record, typically `TradeFile::data()`.
+ * @param count Number of records.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param out Writer receiving one row per trade, in completion order.
+ */
+void price_trades(const TradeRecord* trades, size_t count, const InterestRateHandle& rate_curve, ResultWriter& out);
\ No newline at end of file
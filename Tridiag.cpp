@@ -4,6 +4,38 @@
  */
 
 #include "Tridiag.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+    /**
+     * @brief Size from which `TridiagSolver::Auto` selects the partitioned solver.
+     */
+    const size_t PARTITION_THRESHOLD = 32768;
+
+    /**
+     * @brief Minimum number of rows of a block of the partitioned solver.
+     */
+    const size_t PARTITION_GRAIN = 4096;
+
+    /**
+     * @brief 2x2 matrix of the reduced system of the partitioned solver, stored by rows.
+     */
+    struct Block {
+        double a, b, c, d;
+    };
+
+    /**
+     * @brief Inverts a 2x2 matrix.
+     * @param m Matrix to invert.
+     * @return Inverse of `m`.
+     */
+    Block inverse(const Block& m) {
+        double det = m.a * m.d - m.b * m.c;
+        return { m.d / det, -m.b / det, -m.c / det, m.a / det };
+    }
+}
 
  /**
   * @brief Constructs a Tridiag object with specified subdiagonal, diagonal, and superdiagonal elements.
@@ -11,11 +43,8 @@
   * @param diag Vector containing the diagonal elements.
   * @param superdiag Vector containing the superdiagonal elements.
   */
-Tridiag::Tridiag(std::vector<double> subdiag, std::vector<double> diag, std::vector<double> superdiag) {
-    subdiag_ = subdiag;
-    diag_ = diag;
-    superdiag_ = superdiag;
-}
+Tridiag::Tridiag(ScratchVector subdiag, ScratchVector diag, ScratchVector superdiag)
+    : subdiag_(std::move(subdiag)), diag_(std::move(diag)), superdiag_(std::move(superdiag)) {}
 
 /**
  * @brief Multiplies the tridiagonal matrix by a vector.
@@ -26,9 +55,23 @@ Tridiag::Tridiag(std::vector<double> subdiag, std::vector<double> diag, std::vec
  * @param x The vector to multiply.
  * @return Resulting vector \( b \) after multiplication.
  */
-std::vector<double> Tridiag::operator*(std::vector<double> x) {
+ScratchVector Tridiag::operator*(const ScratchVector& x) const {
+    ScratchVector b(x.size());
+    multiply(x, b);
+    return b;
+}
+
+/**
+ * @brief Multiplies the tridiagonal matrix by a vector into an existing vector.
+ *
+ * Same product as `operator*`, written into storage owned by the caller so that the
+ * time-stepping loops can keep their buffers across steps.
+ *
+ * @param x The vector to multiply.
+ * @param b Output vector, already sized as `x`; it must not alias `x`.
+ */
+void Tridiag::multiply(const ScratchVector& x, ScratchVector& b) const {
     size_t n = x.size();
-    std::vector<double> b(n);
 
     b[0] = (diag_[0] * x[0] + superdiag_[0] * x[1]);
     size_t ii = 1;
@@ -36,38 +79,219 @@ std::vector<double> Tridiag::operator*(std::vector<double> x) {
         b[ii] = (subdiag_[ii - 1] * x[ii - 1] + diag_[ii] * x[ii] + superdiag_[ii] * x[ii + 1]);
     }
     b[ii] = (subdiag_[ii - 1] * x[ii - 1] + diag_[ii] * x[ii]);
-
-    return b;
 }
 
 /**
  * @brief Solves the system of linear equations \( A \cdot x = b \), where \( A \) is a tridiagonal matrix.
  *
- * This method uses LU decomposition to split \( A \) into a lower triangular matrix \( L \) and an upper triangular matrix \( U \).
- * The solution is obtained in two steps:
+ * This method uses LU decomposition to split \( A \) into a unit lower triangular matrix \( L \) and an upper triangular matrix \( U \)
+ * whose superdiagonal is the superdiagonal of \( A \).
+ * The solution is obtained in two steps, both performed in place on \( b \):
  * 1. Forward substitution to solve \( L \cdot y = b \).
  * 2. Backward substitution to solve \( U \cdot x = y \).
  *
  * @param b Right-hand side vector of the system.
  * @return Solution vector \( x \).
  */
-std::vector<double> Tridiag::solve(std::vector<double> b) {
+ScratchVector Tridiag::solve(ScratchVector b) const {
     size_t n = b.size();
 
-    std::vector<double> l(n - 1), v(n);
-    std::vector<double> c = superdiag_;
+    ScratchVector v(n);
+
+    v[0] = diag_[0];
+    for (size_t ii = 0; ii < subdiag_.size(); ii++) {
+        double l = subdiag_[ii] / v[ii];
+        v[ii + 1] = diag_[ii + 1] - l * superdiag_[ii];
+        b[ii + 1] -= l * b[ii];
+    }
+
+    b[n - 1] = b[n - 1] / v[n - 1];
+    for (size_t ii = n - 1; ii > 0; ii--) {
+        b[ii - 1] = (b[ii - 1] - superdiag_[ii - 1] * b[ii]) / v[ii - 1];
+    }
+
+    return b;
+}
+
+/**
+ * @brief Solves \( A \cdot x = D \cdot f + k \) in one forward and one backward pass.
+ *
+ * Row \( i \) of the right-hand side is formed from \( f_{i-1}, f_i, f_{i+1} \) and eliminated at
+ * once, so the right-hand side never exists as a separate vector: the forward pass streams \( f \),
+ * the two matrices and \( x \), the backward pass only \( x \), the pivots and the superdiagonal.
+ * The arithmetic is the one of `multiply` followed by `solve`, operation for operation.
+ *
+ * @param D Tridiagonal matrix of the explicit half-step, of the same size.
+ * @param f Values at the previous time level.
+ * @param k Terms added to the first and last rows of the right-hand side.
+ * @param x Output, `size()` values; it must not alias `f`.
+ */
+void Tridiag::solve_product(const Tridiag& D, const double* f, std::pair<double, double> k, double* x) const {
+    size_t n = diag_.size();
+    const double* dl = D.subdiag_.data();
+    const double* dd = D.diag_.data();
+    const double* du = D.superdiag_.data();
+
+    ScratchVector v(n);
+
+    v[0] = diag_[0];
+    x[0] = (dd[0] * f[0] + du[0] * f[1]) + k.first;
+    for (size_t ii = 1; ii < n - 1; ii++) {
+        double l = subdiag_[ii - 1] / v[ii - 1];
+        v[ii] = diag_[ii] - l * superdiag_[ii - 1];
+        x[ii] = (dl[ii - 1] * f[ii - 1] + dd[ii] * f[ii] + du[ii] * f[ii + 1]) - l * x[ii - 1];
+    }
+    double l = subdiag_[n - 2] / v[n - 2];
+    v[n - 1] = diag_[n - 1] - l * superdiag_[n - 2];
+    x[n - 1] = ((dl[n - 2] * f[n - 2] + dd[n - 1] * f[n - 1]) + k.second) - l * x[n - 2];
+
+    x[n - 1] = x[n - 1] / v[n - 1];
+    for (size_t ii = n - 1; ii > 0; ii--) {
+        x[ii - 1] = (x[ii - 1] - superdiag_[ii - 1] * x[ii]) / v[ii - 1];
+    }
+}
+
+/**
+ * @brief Solves the system for several right-hand sides stored row by row.
+ *
+ * The pivots are computed once; each step of the elimination and of the back substitution then
+ * updates every right-hand side in one contiguous pass over a row. Each lane gets the arithmetic
+ * of `solve`, operation for operation.
+ *
+ * @param b Right-hand sides, row \( i \) of lane \( l \) at `b[i * stride + l]`; overwritten with the solutions.
+ * @param lanes Number of right-hand sides.
+ * @param stride Distance between two rows of `b`, at least `lanes`.
+ */
+void Tridiag::solve_lanes(double* b, size_t lanes, size_t stride) const {
+    size_t n = diag_.size();
+    ScratchVector v(n);
 
     v[0] = diag_[0];
     for (size_t ii = 0; ii < subdiag_.size(); ii++) {
-        l[ii] = subdiag_[ii] / v[ii];
-        v[ii + 1] = diag_[ii + 1] - l[ii] * c[ii];
+        double l = subdiag_[ii] / v[ii];
+        v[ii + 1] = diag_[ii + 1] - l * superdiag_[ii];
+        const double* prev = b + ii * stride;
+        double* row = b + (ii + 1) * stride;
+        for (size_t ll = 0; ll < lanes; ll++) {
+            row[ll] -= l * prev[ll];
+        }
     }
 
-    Lower L(l, std::vector<double>(diag_.size(), 1.0));
-    Upper U(v, c);
+    double* last = b + (n - 1) * stride;
+    for (size_t ll = 0; ll < lanes; ll++) {
+        last[ll] = last[ll] / v[n - 1];
+    }
+    for (size_t ii = n - 1; ii > 0; ii--) {
+        const double* next = b + ii * stride;
+        double* row = b + (ii - 1) * stride;
+        for (size_t ll = 0; ll < lanes; ll++) {
+            row[ll] = (row[ll] - superdiag_[ii - 1] * next[ll]) / v[ii - 1];
+        }
+    }
+}
 
-    std::vector<double> y = L.solve(b);
-    std::vector<double> x = U.solve(y);
+/**
+ * @brief Tells which algorithm `Auto` selects for a system of the given size.
+ *
+ * The partitioned solver does about twice the arithmetic of the Thomas recurrence, so it is only
+ * selected from `PARTITION_THRESHOLD` unknowns and when the global pool has more than one thread.
+ *
+ * @param n Number of unknowns.
+ * @return `Thomas` or `Partitioned`.
+ */
+TridiagSolver Tridiag::solver(size_t n) {
+    return n >= PARTITION_THRESHOLD && ThreadPool::global().size() > 1 ? TridiagSolver::Partitioned : TridiagSolver::Thomas;
+}
 
-    return x;
+/**
+ * @brief Solves the system \( A \cdot x = b \) with the given algorithm.
+ *
+ * The partitioned (SPIKE) solver splits the rows in \( p \) contiguous blocks \( A_k \), one per
+ * thread. Each block is factorized independently and solved for three right-hand sides: the local
+ * part of \( b \), giving \( y \), and the two columns that couple it to its neighbours, giving the
+ * spikes \( w \) (left) and \( z \) (right). The solution on block \( k \) is then
+ * \[
+ * x = y - w \, x_{s_k - 1} - z \, x_{e_k},
+ * \]
+ * where \( s_k \) and \( e_k \) are the first row of the block and of the next one. Writing this relation
+ * at the first and last row of each block gives a reduced system on the \( 2(p - 1) \) unknowns
+ * around the block boundaries, which is block tridiagonal with 2x2 blocks and solved serially.
+ * A last parallel pass applies the spikes.
+ *
+ * The three right-hand sides of a block share the loops of its factorization, which gives the
+ * compiler independent operations to interleave.
+ *
+ * @param b Right-hand side vector of the system.
+ * @param solver Algorithm to use.
+ * @return Solution vector \( x \).
+ */
+ScratchVector Tridiag::solve(ScratchVector b, TridiagSolver solver) const {
+    size_t n = b.size();
+    if (solver == TridiagSolver::Auto) solver = Tridiag::solver(n);
+    size_t p = std::min(ThreadPool::global().size(), n / PARTITION_GRAIN);
+    if (solver == TridiagSolver::Thomas || p < 2) return solve(std::move(b));
+
+    ScratchVector v(n), w(n), z(n);
+    ScratchVector bounds(2 * p);
+
+    ThreadPool::global().run(p, [&](size_t kk) {
+        size_t s = n * kk / p;
+        size_t e = n * (kk + 1) / p;
+
+        v[s] = diag_[s];
+        w[s] = s > 0 ? subdiag_[s - 1] : 0.0;
+        for (size_t ii = s + 1; ii < e; ii++) {
+            double l = subdiag_[ii - 1] / v[ii - 1];
+            v[ii] = diag_[ii] - l * superdiag_[ii - 1];
+            b[ii] -= l * b[ii - 1];
+            w[ii] = -l * w[ii - 1];
+        }
+
+        b[e - 1] /= v[e - 1];
+        w[e - 1] /= v[e - 1];
+        z[e - 1] = e < n ? superdiag_[e - 1] / v[e - 1] : 0.0;
+        for (size_t ii = e - 1; ii > s; ii--) {
+            b[ii - 1] = (b[ii - 1] - superdiag_[ii - 1] * b[ii]) / v[ii - 1];
+            w[ii - 1] = (w[ii - 1] - superdiag_[ii - 1] * w[ii]) / v[ii - 1];
+            z[ii - 1] = -superdiag_[ii - 1] * z[ii] / v[ii - 1];
+        }
+    });
+
+    // Reduced system on U_j = (x[e_j - 1], x[e_j]), the two rows around the boundary j:
+    // L_j U_{j-1} + D_j U_j + R_j U_{j+1} = r_j, solved by block forward elimination.
+    std::vector<Block> D(p - 1);
+    std::vector<std::pair<double, double>> r(p - 1);
+    for (size_t jj = 0; jj + 1 < p; jj++) {
+        size_t e = n * (jj + 1) / p;
+        D[jj] = { 1.0, z[e - 1], w[e], 1.0 };
+        r[jj] = std::make_pair(b[e - 1], b[e]);
+        if (jj > 0) {
+            // L_j has the single entry w[e - 1] acting on x[e_{j-1} - 1]; R_{j-1} has z[e_{j-1}] acting on x[e_j].
+            size_t e_prev = n * jj / p;
+            Block inv = inverse(D[jj - 1]);
+            double m0 = w[e - 1] * inv.a, m1 = w[e - 1] * inv.b;
+            D[jj].b -= m1 * z[e_prev];
+            r[jj].first -= m0 * r[jj - 1].first + m1 * r[jj - 1].second;
+        }
+    }
+    for (size_t jj = p - 1; jj-- > 0;) {
+        size_t e = n * (jj + 1) / p;
+        double rhs1 = r[jj].second;
+        if (jj + 2 < p) rhs1 -= z[e] * bounds[2 * jj + 3];
+        Block inv = inverse(D[jj]);
+        bounds[2 * jj] = inv.a * r[jj].first + inv.b * rhs1;
+        bounds[2 * jj + 1] = inv.c * r[jj].first + inv.d * rhs1;
+    }
+
+    ThreadPool::global().run(p, [&](size_t kk) {
+        size_t s = n * kk / p;
+        size_t e = n * (kk + 1) / p;
+        double left = kk > 0 ? bounds[2 * (kk - 1)] : 0.0;
+        double right = kk + 1 < p ? bounds[2 * kk + 1] : 0.0;
+        for (size_t ii = s; ii < e; ii++) {
+            b[ii] -= w[ii] * left + z[ii] * right;
+        }
+    });
+
+    return b;
 }
\ No newline at end of file
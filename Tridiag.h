@@ -5,9 +5,21 @@
 
 #pragma once
 
+#include "Arena.h"
+
 #include <vector>
 #include <iostream>
 #include <iomanip>
+#include <utility>
+
+/**
+ * @brief Algorithm used to solve a tridiagonal system.
+ */
+enum class TridiagSolver {
+    Auto,       ///< `Partitioned` for large systems when several threads are available, `Thomas` otherwise.
+    Thomas,     ///< Serial LU (Thomas) recurrence.
+    Partitioned ///< SPIKE-style partitioned solve, one block per thread of `ThreadPool::global()`.
+};
 
 /**
  * @class Lower
@@ -15,8 +27,8 @@
  */
 class Lower {
 
-    std::vector<double> subdiag_;
-    std::vector<double> diag_;
+    ScratchVector subdiag_;
+    ScratchVector diag_;
 
 public:
     /**
@@ -24,20 +36,22 @@ public:
      * @param subdiag Vector containing subdiagonal elements.
      * @param diag Vector containing diagonal elements.
      */
-    Lower(std::vector<double> subdiag, std::vector<double> diag) : subdiag_(subdiag), diag_(diag) {}
+    Lower(ScratchVector subdiag, ScratchVector diag) : subdiag_(std::move(subdiag)), diag_(std::move(diag)) {}
 
     /**
      * @brief Solves a system of equations for the lower triangular matrix.
+     *
+     * The solution overwrites the right-hand side, so passing an rvalue avoids any allocation.
+     *
      * @param b The right-hand side vector.
      * @return Solution vector.
      */
-    std::vector<double> solve(std::vector<double> b) {
-        std::vector<double> x(b.size());
-        x[0] = b[0] / diag_[0];
+    ScratchVector solve(ScratchVector b) const {
+        b[0] = b[0] / diag_[0];
         for (size_t ii = 1; ii < b.size(); ii++) {
-            x[ii] = (b[ii] - subdiag_[ii - 1] * x[ii - 1]) / diag_[ii];
+            b[ii] = (b[ii] - subdiag_[ii - 1] * b[ii - 1]) / diag_[ii];
         }
-        return x;
+        return b;
     }
 };
 
@@ -47,8 +61,8 @@ public:
  */
 class Upper {
 
-    std::vector<double> diag_;
-    std::vector<double> superdiag_;
+    ScratchVector diag_;
+    ScratchVector superdiag_;
 
 public:
     /**
@@ -56,23 +70,25 @@ public:
      * @param diag Vector containing diagonal elements.
      * @param superdiag Vector containing superdiagonal elements.
      */
-    Upper(std::vector<double> diag, std::vector<double> superdiag) : diag_(diag), superdiag_(superdiag) {}
+    Upper(ScratchVector diag, ScratchVector superdiag) : diag_(std::move(diag)), superdiag_(std::move(superdiag)) {}
 
     /**
      * @brief Solves a system of equations for the upper triangular matrix.
+     *
+     * The solution overwrites the right-hand side, so passing an rvalue avoids any allocation.
+     *
      * @param b The right-hand side vector.
      * @return Solution vector.
      */
-    std::vector<double> solve(std::vector<double> b) {
+    ScratchVector solve(ScratchVector b) const {
         size_t n = b.size();
-        std::vector<double> x(n);
-        x[n - 1] = b[n - 1] / diag_[n - 1];
+        b[n - 1] = b[n - 1] / diag_[n - 1];
         size_t ii;
         for (ii = n - 2; ii >= 1; ii--) {
-            x[ii] = (b[ii] - superdiag_[ii] * x[ii + 1]) / diag_[ii];
+            b[ii] = (b[ii] - superdiag_[ii] * b[ii + 1]) / diag_[ii];
         }
-        x[ii] = (b[ii] - superdiag_[ii] * x[ii + 1]) / diag_[ii];
-        return x;
+        b[ii] = (b[ii] - superdiag_[ii] * b[ii + 1]) / diag_[ii];
+        return b;
     }
 };
 
@@ -82,9 +98,9 @@ public:
  */
 class Tridiag {
 
-    std::vector<double> subdiag_;
-    std::vector<double> diag_;
-    std::vector<double> superdiag_;
+    ScratchVector subdiag_;
+    ScratchVector diag_;
+    ScratchVector superdiag_;
 
 public:
     /**
@@ -94,25 +110,118 @@ public:
 
     /**
      * @brief Constructs a Tridiag object with specified subdiagonal, diagonal, and superdiagonal elements.
+     *
+     * The vectors are moved into the matrix: pass rvalues to avoid copying them.
+     *
      * @param subdiag Vector containing subdiagonal elements.
      * @param diag Vector containing diagonal elements.
      * @param superdiag Vector containing superdiagonal elements.
      */
-    Tridiag(std::vector<double> subdiag, std::vector<double> diag, std::vector<double> superdiag);
+    Tridiag(ScratchVector subdiag, ScratchVector diag, ScratchVector superdiag);
 
     /**
      * @brief Multiplies the tridiagonal matrix by a vector.
      * @param x Input vector.
      * @return Resulting vector after multiplication.
      */
-    std::vector<double> operator*(std::vector<double> x);
+    ScratchVector operator*(const ScratchVector& x) const;
+
+    /**
+     * @brief Multiplies the tridiagonal matrix by a vector into an existing vector.
+     * @param x Input vector.
+     * @param b Output vector, already sized as `x`; it must not alias `x`.
+     */
+    void multiply(const ScratchVector& x, ScratchVector& b) const;
 
     /**
      * @brief Solves a system of equations for the tridiagonal matrix.
+     *
+     * The solution overwrites the right-hand side, so passing an rvalue avoids copying it.
+     *
      * @param b The right-hand side vector.
      * @return Solution vector.
      */
-    std::vector<double> solve(std::vector<double> b);
+    ScratchVector solve(ScratchVector b) const;
+
+    /**
+     * @brief Solves a system of equations for the tridiagonal matrix with the given algorithm.
+     *
+     * The partitioned solver assumes a diagonally dominant matrix, as the Thomas recurrence does;
+     * both give the same solution up to rounding.
+     *
+     * @param b The right-hand side vector.
+     * @param solver Algorithm to use.
+     * @return Solution vector.
+     */
+    ScratchVector solve(ScratchVector b, TridiagSolver solver) const;
+
+    /**
+     * @brief Solves \( A \cdot x = D \cdot f + k \) in one forward and one backward pass.
+     *
+     * Fused Crank-Nicolson step: the explicit product, the boundary terms and the forward
+     * elimination share a single pass, the back substitution writes the solution in `x`.
+     *
+     * @param D Tridiagonal matrix of the explicit half-step, of the same size.
+     * @param f Values at the previous time level.
+     * @param k Terms added to the first and last rows of the right-hand side.
+     * @param x Output, `size()` values; it must not alias `f`.
+     */
+    void solve_product(const Tridiag& D, const double* f, std::pair<double, double> k, double* x) const;
+
+    /**
+     * @brief Solves the system for several right-hand sides stored row by row.
+     *
+     * One factorization serves all the right-hand sides, and each row is updated for all of them
+     * in a contiguous pass, which suits batches of systems sharing the same matrix.
+     *
+     * @param b Right-hand sides, row \( i \) of lane \( l \) at `b[i * stride + l]`; overwritten with the solutions.
+     * @param lanes Number of right-hand sides.
+     * @param stride Distance between two rows of `b`, at least `lanes`.
+     */
+    void solve_lanes(double* b, size_t lanes, size_t stride) const;
+
+    /**
+     * @brief Tells which algorithm `Auto` selects for a system of the given size.
+     * @param n Number of unknowns.
+     * @return `Thomas` or `Partitioned`.
+     */
+    static TridiagSolver solver(size_t n);
+
+    /**
+     * @brief Returns the subdiagonal elements.
+     * @return Read-only reference to the subdiagonal.
+     */
+    const ScratchVector& subdiag() const { return subdiag_; }
+
+    /**
+     * @brief Returns the diagonal elements.
+     * @return Read-only reference to the diagonal.
+     */
+    const ScratchVector& diag() const { return diag_; }
+
+    /**
+     * @brief Returns the superdiagonal elements.
+     * @return Read-only reference to the superdiagonal.
+     */
+    const ScratchVector& superdiag() const { return superdiag_; }
+
+    /**
+     * @brief Returns the subdiagonal elements for in-place updates.
+     * @return Reference to the subdiagonal.
+     */
+    ScratchVector& subdiag() { return subdiag_; }
+
+    /**
+     * @brief Returns the diagonal elements for in-place updates.
+     * @return Reference to the diagonal.
+     */
+    ScratchVector& diag() { return diag_; }
+
+    /**
+     * @brief Returns the superdiagonal elements for in-place updates.
+     * @return Reference to the superdiagonal.
+     */
+    ScratchVector& superdiag() { return superdiag_; }
 
     /**
      * @brief Returns the size of the tridiagonal matrix.
@@ -0,0 +1,396 @@
+/**
+ * @file TwoAssetOption.cpp
+ * @brief Contains the methods of the two-asset Douglas ADI pricer.
+ */
+
+#include "TwoAssetOption.h"
+#include "Arena.h"
+#include "ThreadPool.h"
+#include "Tridiag.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Weight of the implicit stages of the Douglas scheme.
+     */
+    const double DOUGLAS_THETA = 0.5;
+
+    /**
+     * @brief Minimum number of grid lines per task of the parallel loops.
+     */
+    const size_t LINE_GRAIN = 8;
+
+    /**
+     * @brief Quadratic Lagrange weights on the nodes \( m - 1, m, m + 1 \), or their derivatives.
+     * @param t Position relative to node \( m \), in steps.
+     * @param order Order of the derivative (0, 1 or 2), per step.
+     * @param w Output weights.
+     */
+    void lagrange(double t, int order, double* w) {
+        if (order == 0) {
+            w[0] = t * (t - 1) / 2;
+            w[1] = 1 - t * t;
+            w[2] = t * (t + 1) / 2;
+        }
+        else if (order == 1) {
+            w[0] = t - 0.5;
+            w[1] = -2 * t;
+            w[2] = t + 0.5;
+        }
+        else {
+            w[0] = 1;
+            w[1] = -2;
+            w[2] = 1;
+        }
+    }
+
+    /**
+     * @brief Builds \( I - w A_k \) for the nodes \( 0, \dots, n - 1 \) of one direction.
+     *
+     * Node \( i \) of \( A_k \) has the weights \( a - b \), \( -2a - r/2 \), \( a + b \) with
+     * \( a = \tfrac{1}{2} \sigma^2 i^2 \) and \( b = \tfrac{1}{2} (r - q) i \); the row of node 0 is
+     * the discount term alone.
+     *
+     * @param n Number of unknowns of a line.
+     * @param sigma Volatility of the asset.
+     * @param drift Risk-neutral drift \( r - q \).
+     * @param r Short rate.
+     * @param w Weight of the implicit operator, \( \theta \Delta \tau \).
+     * @return Matrix of the line solves; its storage lives in the enclosing arena scope.
+     */
+    Tridiag line_matrix(size_t n, double sigma, double drift, double r, double w) {
+        Tridiag C(ScratchVector(n - 1), ScratchVector(n), ScratchVector(n - 1));
+        for (size_t ii = 0; ii < n; ii++) {
+            double a = 0.5 * sigma * sigma * ii * ii, b = 0.5 * drift * ii;
+            if (ii > 0) C.subdiag()[ii - 1] = -w * (a - b);
+            C.diag()[ii] = 1 + w * (2 * a + r / 2);
+            if (ii < n - 1) C.superdiag()[ii] = -w * (a + b);
+        }
+        return C;
+    }
+}
+
+// Definition of the in-class constant, which std::min binds to a reference.
+const size_t TwoAssetOption::TILE;
+
+/**
+ * @brief Constructs and prices a two-asset option.
+ * @param payoff Kind of payoff.
+ * @param contract_type Type of option: 1 for Call, -1 for Put.
+ * @param exercise_type Exercise type: 1 for European, 0 for American.
+ * @param T Maturity time.
+ * @param K Strike price.
+ * @param T0 Start time.
+ * @param time_mesh Number of time steps.
+ * @param spot_mesh Number of spot steps along each asset.
+ * @param first First underlying asset.
+ * @param second Second underlying asset.
+ * @param rho Correlation of the two assets.
+ * @param rate_curve Shared, immutable interest rate curve.
+ */
+TwoAssetOption::TwoAssetOption(TwoAssetPayoff payoff, int contract_type, int exercise_type, double T, double K, double T0, unsigned int time_mesh,
+    unsigned int spot_mesh, const Underlying& first, const Underlying& second, double rho, InterestRateHandle rate_curve)
+    : payoff_(payoff), contract_type_(contract_type), exercise_type_(exercise_type), T_(T), K_(K), T0_(T0), time_mesh_(time_mesh), spot_mesh_(spot_mesh),
+    first_(first), second_(second), rho_(rho), curve(std::move(rate_curve)) {
+    if (first_.S_max <= 0) first_.S_max = 5 * first_.S0;
+    if (second_.S_max <= 0) second_.S_max = 5 * second_.S0;
+    setup();
+}
+
+/**
+ * @brief Validates the parameters, sets up the mesh and prices the option.
+ */
+void TwoAssetOption::setup() {
+    if (contract_type_ != 1 && contract_type_ != -1) throw InvalidContractType(contract_type_);
+    if (exercise_type_ != 1 && exercise_type_ != 0) throw InvalidExerciseType(exercise_type_);
+    if (T_ <= T0_ || T_ < 0) throw InvalidMaturity();
+    if (K_ < 0 || (K_ == 0 && payoff_ != TwoAssetPayoff::Spread)) throw InvalidStrike(K_);
+    if (time_mesh_ <= 0) throw InvalidTimeMesh(time_mesh_);
+    if (spot_mesh_ < 3) throw InvalidSpotMesh(spot_mesh_);
+    for (const Underlying* asset : { &first_, &second_ }) {
+        if (asset->S0 <= 0) throw InvalidSpot(asset->S0);
+        if (!(asset->volatility > 0)) throw InvalidVolatility(asset->volatility);
+        if (asset->S_max <= asset->S0) throw InvalidDomain(asset->S_max);
+    }
+    if (!(std::fabs(rho_) <= 1)) throw InvalidCorrelation(rho_);
+
+    dT = (T_ - T0_) / time_mesh_;
+    dS1 = first_.S_max / spot_mesh_;
+    dS2 = second_.S_max / spot_mesh_;
+    solve();
+}
+
+/**
+ * @brief Returns the payoff at a pair of spot prices.
+ * @param S1 Spot price of the first asset.
+ * @param S2 Spot price of the second asset.
+ * @return Exercise value.
+ */
+double TwoAssetOption::payoff(double S1, double S2) const {
+    double underlying;
+    switch (payoff_) {
+    case TwoAssetPayoff::Spread:
+        underlying = S1 - S2;
+        break;
+    case TwoAssetPayoff::Max:
+        underlying = std::max(S1, S2);
+        break;
+    default:
+        underlying = std::min(S1, S2);
+        break;
+    }
+    return std::max(contract_type_ * (underlying - K_), 0.0);
+}
+
+/**
+ * @brief Writes the Dirichlet values of the boundaries \( S_1 = S_{1,max} \) and \( S_2 = S_{2,max} \).
+ *
+ * The value is the discounted payoff of the forwards,
+ * \( D \, g(S_1 e^{-q_1 \tau} / D, S_2 e^{-q_2 \tau} / D) \) with \( D \) the discount factor over
+ * \( \tau \); it is exact wherever the payoff is linear in the forwards. American options take the
+ * maximum with the payoff.
+ *
+ * @param u Grid values, line of \( S_2 \) by line of \( S_2 \).
+ * @param tau Time to maturity.
+ */
+void TwoAssetOption::set_boundaries(double* u, double tau) const {
+    double disc = std::exp(-(curve->integral(T_ - T0_ - tau) - curve->integral(T_ - T0_)));
+    double g1 = std::exp(-first_.yield * tau) / disc, g2 = std::exp(-second_.yield * tau) / disc;
+    auto edge = [&](size_t ii, size_t jj) {
+        double S1 = ii * dS1, S2 = jj * dS2;
+        double v = disc * payoff(S1 * g1, S2 * g2);
+        u[index(ii, jj)] = exercise_type_ ? v : std::max(v, payoff(S1, S2));
+    };
+    for (size_t jj = 0; jj <= spot_mesh_; jj++) edge(spot_mesh_, jj);
+    for (size_t ii = 0; ii < spot_mesh_; ii++) edge(ii, spot_mesh_);
+}
+
+/**
+ * @brief Forms the right-hand side of the first implicit stage, \( u + \Delta\tau (A_0 + (1 - \theta) A_1 + A_2) u \).
+ *
+ * \( A_0 \) is \( \rho \sigma_1 \sigma_2 S_1 S_2 u_{S_1 S_2} \) with the four-point central difference;
+ * it vanishes on \( S_1 = 0 \) and \( S_2 = 0 \), as the first-order terms of \( A_1 \) and \( A_2 \) do.
+ *
+ * @param u Grid values.
+ * @param y Result at the unknown nodes; the boundary nodes are left untouched.
+ * @param r Short rate.
+ */
+void TwoAssetOption::explicit_stage(const double* u, double* y, double r) const {
+    size_t row = spot_mesh_ + 1;
+    double c = rho_ * first_.volatility * second_.volatility / 4;
+    double s1 = 0.5 * first_.volatility * first_.volatility, m1 = 0.5 * (r - first_.yield);
+    double s2 = 0.5 * second_.volatility * second_.volatility, m2 = 0.5 * (r - second_.yield);
+    double w1 = (1 - DOUGLAS_THETA) * dT;
+    ThreadPool::global().parallel_for(0, spot_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            const double* x = u + index(0, jj);
+            double* res = y + index(0, jj);
+            double a2 = s2 * jj * jj, b2 = m2 * jj;
+            for (size_t ii = 0; ii < spot_mesh_; ii++) {
+                double a1 = s1 * ii * ii, b1 = m1 * ii;
+                double f1 = (-2 * a1 - r / 2) * x[ii];
+                double f2 = (-2 * a2 - r / 2) * x[ii];
+                double f0 = 0;
+                if (ii > 0) f1 += (a1 - b1) * x[ii - 1] + (a1 + b1) * x[ii + 1];
+                if (jj > 0) f2 += (a2 - b2) * x[ii - row] + (a2 + b2) * x[ii + row];
+                if (ii > 0 && jj > 0) f0 = c * ii * jj * (x[ii + 1 + row] - x[ii + 1 - row] - x[ii - 1 + row] + x[ii - 1 - row]);
+                res[ii] = x[ii] + dT * (f0 + f2) + w1 * f1;
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Subtracts \( \theta \Delta\tau A_2 u \) from the unknown nodes, to form the right-hand side of the second stage.
+ * @param u Grid values at the start of the step.
+ * @param y Solution of the first stage.
+ * @param r Short rate.
+ */
+void TwoAssetOption::subtract_second(const double* u, double* y, double r) const {
+    size_t row = spot_mesh_ + 1;
+    double s2 = 0.5 * second_.volatility * second_.volatility, m2 = 0.5 * (r - second_.yield);
+    double w = DOUGLAS_THETA * dT;
+    ThreadPool::global().parallel_for(0, spot_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            const double* x = u + index(0, jj);
+            double* res = y + index(0, jj);
+            double a2 = s2 * jj * jj, b2 = m2 * jj;
+            for (size_t ii = 0; ii < spot_mesh_; ii++) {
+                double f2 = (-2 * a2 - r / 2) * x[ii];
+                if (jj > 0) f2 += (a2 - b2) * x[ii - row] + (a2 + b2) * x[ii + row];
+                res[ii] -= w * f2;
+            }
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Solves \( (I - \theta \Delta\tau A_1) y = b \) on every line of \( S_1 \) below \( S_{2,max} \).
+ *
+ * Each line is contiguous and solved in place as a single lane of `Tridiag::solve_lanes`.
+ *
+ * @param y Right-hand side at the unknown nodes and new boundary values; overwritten with the solution.
+ * @param r Short rate.
+ */
+void TwoAssetOption::solve_first(double* y, double r) const {
+    ArenaScope lines;
+    size_t n = spot_mesh_;
+    double w = DOUGLAS_THETA * dT;
+    double a = 0.5 * first_.volatility * first_.volatility * (n - 1) * (n - 1), b = 0.5 * (r - first_.yield) * (n - 1);
+    Tridiag C = line_matrix(n, first_.volatility, r - first_.yield, r, w);
+    ThreadPool::global().parallel_for(0, spot_mesh_, [&](size_t lo, size_t hi) {
+        for (size_t jj = lo; jj < hi; jj++) {
+            double* x = y + index(0, jj);
+            x[n - 1] += w * (a + b) * x[n];
+            C.solve_lanes(x, 1, 1);
+        }
+    }, LINE_GRAIN);
+}
+
+/**
+ * @brief Solves \( (I - \theta \Delta\tau A_2) y = b \) on every line of \( S_2 \) below \( S_{1,max} \).
+ *
+ * The lines are strided in memory; they are solved in tiles of `TILE` adjacent columns as the lanes
+ * of `Tridiag::solve_lanes`, so that each elimination sweeps short contiguous runs of a tile that
+ * stays in cache, and the tiles are split across the pool.
+ *
+ * @param y Right-hand side at the unknown nodes and new boundary values; overwritten with the solution.
+ * @param r Short rate.
+ */
+void TwoAssetOption::solve_second(double* y, double r) const {
+    ArenaScope lines;
+    size_t n = spot_mesh_;
+    size_t row = spot_mesh_ + 1;
+    double w = DOUGLAS_THETA * dT;
+    double a = 0.5 * second_.volatility * second_.volatility * (n - 1) * (n - 1), b = 0.5 * (r - second_.yield) * (n - 1);
+    Tridiag C = line_matrix(n, second_.volatility, r - second_.yield, r, w);
+    size_t tiles = (n + TILE - 1) / TILE;
+    ThreadPool::global().parallel_for(0, tiles, [&](size_t lo, size_t hi) {
+        for (size_t tt = lo; tt < hi; tt++) {
+            size_t first = tt * TILE, lanes = std::min(TILE, n - first);
+            for (size_t ii = first; ii < first + lanes; ii++) {
+                y[index(ii, n - 1)] += w * (a + b) * y[index(ii, n)];
+            }
+            C.solve_lanes(y + first, lanes, row);
+        }
+    });
+}
+
+/**
+ * @brief Runs the backward sweep from the payoff to the initial time.
+ *
+ * One Douglas step from \( \tau_n \) to \( \tau_{n+1} \):
+ * \[
+ * \begin{aligned}
+ * (I - \theta \Delta\tau A_1(\tau_{n+1})) Y_1 &= u + \Delta\tau \left( A_0 + (1 - \theta) A_1 + A_2 \right)(\tau_n) \, u, \\
+ * (I - \theta \Delta\tau A_2(\tau_{n+1})) Y_2 &= Y_1 - \theta \Delta\tau A_2(\tau_n) \, u,
+ * \end{aligned}
+ * \]
+ * and \( u^{n+1} = Y_2 \). Only \( u \) and the stage buffer are allocated; the payoff is recomputed
+ * for the American projection.
+ */
+void TwoAssetOption::solve() {
+    size_t row = spot_mesh_ + 1;
+    size_t size = row * row;
+    std::vector<double> u(size), y(size);
+    for (size_t jj = 0; jj <= spot_mesh_; jj++) {
+        for (size_t ii = 0; ii <= spot_mesh_; ii++) {
+            u[index(ii, jj)] = payoff(ii * dS1, jj * dS2);
+        }
+    }
+
+    for (size_t nn = 0; nn < time_mesh_; nn++) {
+        double tau = dT * nn, tau_next = dT * (nn + 1);
+        double r = (*curve)(T_ - T0_ - tau), r_next = (*curve)(T_ - T0_ - tau_next);
+
+        explicit_stage(u.data(), y.data(), r);
+        set_boundaries(y.data(), tau_next);
+        solve_first(y.data(), r_next);
+        subtract_second(u.data(), y.data(), r);
+        solve_second(y.data(), r_next);
+
+        if (!exercise_type_) {
+            ThreadPool::global().parallel_for(0, spot_mesh_, [&](size_t lo, size_t hi) {
+                for (size_t jj = lo; jj < hi; jj++) {
+                    for (size_t ii = 0; ii < spot_mesh_; ii++) {
+                        double& v = y[index(ii, jj)];
+                        v = std::max(v, payoff(ii * dS1, jj * dS2));
+                    }
+                }
+            }, LINE_GRAIN);
+        }
+        u.swap(y);
+    }
+    grid = std::move(u);
+}
+
+/**
+ * @brief Interpolates the grid values, or their derivatives, with quadratic Lagrange polynomials.
+ * @param S1 Spot price of the first asset.
+ * @param S2 Spot price of the second asset.
+ * @param first_order Order of the derivative in \( S_1 \) (0, 1 or 2).
+ * @param second_order Order of the derivative in \( S_2 \) (0, 1 or 2).
+ * @return Interpolated value or derivative.
+ */
+double TwoAssetOption::interpolate(double S1, double S2, int first_order, int second_order) const {
+    double x1 = S1 / dS1, x2 = S2 / dS2;
+    size_t m1 = static_cast<size_t>(std::min<double>(std::max<double>(std::round(x1), 1), spot_mesh_ - 1));
+    size_t m2 = static_cast<size_t>(std::min<double>(std::max<double>(std::round(x2), 1), spot_mesh_ - 1));
+    double w1[3], w2[3];
+    lagrange(x1 - m1, first_order, w1);
+    lagrange(x2 - m2, second_order, w2);
+
+    double res = 0;
+    for (size_t jj = 0; jj < 3; jj++) {
+        for (size_t ii = 0; ii < 3; ii++) {
+            res += w2[jj] * w1[ii] * grid[index(m1 - 1 + ii, m2 - 1 + jj)];
+        }
+    }
+    return res / (std::pow(dS1, first_order) * std::pow(dS2, second_order));
+}
+
+/**
+ * @brief Returns the option value at any point of the grid domain.
+ * @param S1 Spot price of the first asset.
+ * @param S2 Spot price of the second asset.
+ * @return Interpolated value at \( T_0 \).
+ */
+double TwoAssetOption::value(double S1, double S2) const {
+    return interpolate(S1, S2, 0, 0);
+}
+
+/**
+ * @brief Returns the price of the option.
+ * @return Value at the initial spots and \( T_0 \).
+ */
+double TwoAssetOption::price() const {
+    return value(first_.S0, second_.S0);
+}
+
+/**
+ * @brief Returns the delta with respect to one of the assets.
+ * @param asset 1 or 2.
+ * @return \( \partial V / \partial S_k \) at the initial spots.
+ */
+double TwoAssetOption::delta(int asset) const {
+    return asset == 1 ? interpolate(first_.S0, second_.S0, 1, 0) : interpolate(first_.S0, second_.S0, 0, 1);
+}
+
+/**
+ * @brief Returns the gamma with respect to one of the assets.
+ * @param asset 1 or 2.
+ * @return \( \partial^2 V / \partial S_k^2 \) at the initial spots.
+ */
+double TwoAssetOption::gamma(int asset) const {
+    return asset == 1 ? interpolate(first_.S0, second_.S0, 2, 0) : interpolate(first_.S0, second_.S0, 0, 2);
+}
+
+/**
+ * @brief Returns the cross gamma.
+ * @return \( \partial^2 V / \partial S_1 \partial S_2 \) at the initial spots.
+ */
+double TwoAssetOption::cross_gamma() const {
+    return interpolate(first_.S0, second_.S0, 1, 1);
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * @file VolSurface.cpp
+ * @brief Contains the grouped construction of implied volatility surfaces.
+ */
+
+#include "VolSurface.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+/**
+ * @brief Constructs the surface builder.
+ * @param time_mesh Number of time steps in the grid.
+ * @param spot_mesh Number of spot steps in the grid.
+ * @param rate_curve Shared, immutable interest rate curve.
+ * @param settings Parameters of the implied volatility search.
+ * @param psor Settings of the projected SOR solver used for American exercise.
+ */
+VolSurface::VolSurface(unsigned int time_mesh, unsigned int spot_mesh, InterestRateHandle rate_curve,
+    const ImpliedVolSettings& settings, const PSORSettings& psor)
+    : time_mesh_(time_mesh), spot_mesh_(spot_mesh), curve_(rate_curve), psor_(psor), settings_(settings),
+    solver_(time_mesh, spot_mesh, rate_curve, settings, psor) {}
+
+/**
+ * @brief Runs the Newton iterations of a group of quotes sharing maturity, spot and exercise type.
+ *
+ * The option is built on the first quote of the group at its initial guess, which gives the
+ * price of that quote; every other price comes from `Option::price_scenarios`, one call per
+ * iteration for all the active quotes. The per-quote logic is the Newton phase of
+ * `ImpliedVol::solve`: the bracket is tightened by every price, and a quote whose step leaves
+ * the bracket, whose vega vanishes or which is not converged after `max_newton` iterations is
+ * solved again by `ImpliedVol::solve`, its counters including the work of the batch.
+ *
+ * @param quotes All the quotes of the surface.
+ * @param index Indices in `quotes` of the quotes of the group.
+ * @param count Number of quotes in the group.
+ * @param res Results of all the quotes, written at the indices of the group.
+ */
+void VolSurface::solve_group(const std::vector<VolQuote>& quotes, const size_t* index, size_t count, ImpliedVolResult* res) const {
+    const ImpliedVolSettings& s = settings_;
+    std::vector<double> vol(count), f(count), up(count), lo(count, s.vol_lo), hi(count, s.vol_hi);
+    std::vector<bool> small(count, false);
+    std::vector<size_t> active, retry;
+    for (size_t kk = 0; kk < count; kk++) {
+        vol[kk] = solver_.initial_guess(quotes[index[kk]]);
+        res[index[kk]] = { vol[kk], 0, 0, 0, ImpliedVolStatus::MaxIterations };
+    }
+
+    const VolQuote& first = quotes[index[0]];
+    Option option(first.contract_type, first.exercise_type, first.T, first.K, first.T0, time_mesh_, spot_mesh_, first.S0, curve_, vol[0], psor_);
+
+    // Price and vega bump of every initial guess; the first price comes from the option itself.
+    std::vector<Scenario> scenarios;
+    for (size_t kk = 0; kk < count; kk++) {
+        const VolQuote& q = quotes[index[kk]];
+        if (kk > 0) scenarios.push_back({ q.contract_type, q.K, vol[kk] });
+        scenarios.push_back({ q.contract_type, q.K, vol[kk] * (1 + s.h) });
+        active.push_back(kk);
+    }
+    std::vector<double> p = option.price_scenarios(scenarios);
+    f[0] = option.price() - first.price;
+    up[0] = p[0] - first.price;
+    res[index[0]].pricings = 2;
+    for (size_t kk = 1; kk < count; kk++) {
+        f[kk] = p[2 * kk - 1] - quotes[index[kk]].price;
+        up[kk] = p[2 * kk] - quotes[index[kk]].price;
+        res[index[kk]].pricings = 2;
+    }
+
+    // Newton iterations of the active quotes, priced together.
+    for (size_t it = 0; it < s.max_newton && !active.empty(); it++) {
+        std::vector<size_t> stepped;
+        scenarios.clear();
+        for (size_t kk : active) {
+            ImpliedVolResult& r = res[index[kk]];
+            const VolQuote& q = quotes[index[kk]];
+            if (std::fabs(f[kk]) <= s.tol) {
+                r.vol = vol[kk];
+                r.error = f[kk];
+                r.status = ImpliedVolStatus::Converged;
+                continue;
+            }
+            if (f[kk] < 0) lo[kk] = vol[kk];
+            else hi[kk] = vol[kk];
+
+            double vega = (up[kk] - f[kk]) / (vol[kk] * s.h);
+            double next = vol[kk] - f[kk] / vega;
+            if (!(vega > 0) || !(next > lo[kk] && next < hi[kk])) {
+                retry.push_back(kk);
+                continue;
+            }
+            small[kk] = std::fabs(next - vol[kk]) <= s.vol_tol;
+            vol[kk] = next;
+            scenarios.push_back({ q.contract_type, q.K, next });
+            scenarios.push_back({ q.contract_type, q.K, next * (1 + s.h) });
+            stepped.push_back(kk);
+        }
+        if (stepped.empty()) {
+            active.clear();
+            break;
+        }
+
+        p = option.price_scenarios(scenarios);
+        active.clear();
+        for (size_t jj = 0; jj < stepped.size(); jj++) {
+            size_t kk = stepped[jj];
+            ImpliedVolResult& r = res[index[kk]];
+            f[kk] = p[2 * jj] - quotes[index[kk]].price;
+            up[kk] = p[2 * jj + 1] - quotes[index[kk]].price;
+            r.pricings += 2;
+            r.iterations++;
+            if (small[kk]) {
+                r.vol = vol[kk];
+                r.error = f[kk];
+                r.status = ImpliedVolStatus::Converged;
+            }
+            else active.push_back(kk);
+        }
+    }
+
+    for (size_t kk : active) {
+        ImpliedVolResult& r = res[index[kk]];
+        if (std::fabs(f[kk]) <= s.tol) {
+            r.vol = vol[kk];
+            r.error = f[kk];
+            r.status = ImpliedVolStatus::Converged;
+        }
+        else retry.push_back(kk);
+    }
+
+    // Quotes that Newton could not solve go through the full Newton-Brent search.
+    for (size_t kk : retry) {
+        ImpliedVolResult& r = res[index[kk]];
+        ImpliedVolResult fallback = solver_.solve(quotes[index[kk]]);
+        fallback.iterations += r.iterations;
+        fallback.pricings += r.pricings;
+        r = fallback;
+    }
+}
+
+/**
+ * @brief Computes the implied volatilities of a set of quotes and arranges them on a grid.
+ *
+ * The quotes are sorted by maturity, initial time, spot and exercise type; each run of equal keys
+ * is a group, split into chunks of at most `CHUNK` quotes of similar size. The chunks are the
+ * tasks of one batch on `ThreadPool::global()`.
+ *
+ * @param quotes Option quotes.
+ * @return Strike by maturity grid of implied volatilities and per-quote results.
+ */
+VolSurfaceResult VolSurface::build(const std::vector<VolQuote>& quotes) const {
+    VolSurfaceResult res;
+    size_t n = quotes.size();
+    res.quotes.resize(n);
+
+    auto key = [&](size_t ii) {
+        const VolQuote& q = quotes[ii];
+        return std::make_tuple(q.T, q.T0, q.S0, q.exercise_type);
+    };
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) < key(b); });
+
+    std::vector<std::pair<size_t, size_t>> chunks;
+    for (size_t begin = 0, end = 0; begin < n; begin = end) {
+        while (end < n && key(order[end]) == key(order[begin])) end++;
+        size_t pieces = (end - begin + CHUNK - 1) / CHUNK;
+        for (size_t ii = 0; ii < pieces; ii++) {
+            chunks.emplace_back(begin + (end - begin) * ii / pieces, begin + (end - begin) * (ii + 1) / pieces);
+        }
+    }
+    ThreadPool::global().run(chunks.size(), [&](size_t ii) {
+        solve_group(quotes, order.data() + chunks[ii].first, chunks[ii].second - chunks[ii].first, res.quotes.data());
+    });
+
+    for (const VolQuote& q : quotes) {
+        res.strikes.push_back(q.K);
+        res.maturities.push_back(q.T);
+    }
+    std::sort(res.strikes.begin(), res.strikes.end());
+    res.strikes.erase(std::unique(res.strikes.begin(), res.strikes.end()), res.strikes.end());
+    std::sort(res.maturities.begin(), res.maturities.end());
+    res.maturities.erase(std::unique(res.maturities.begin(), res.maturities.end()), res.maturities.end());
+
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    res.points.assign(res.strikes.size() * res.maturities.size(), { nan, nan, 0, 0, ImpliedVolStatus::NoQuote });
+    for (size_t ii = 0; ii < n; ii++) {
+        size_t kk = std::lower_bound(res.strikes.begin(), res.strikes.end(), quotes[ii].K) - res.strikes.begin();
+        size_t tt = std::lower_bound(res.maturities.begin(), res.maturities.end(), quotes[ii].T) - res.maturities.begin();
+        res.points[tt * res.strikes.size() + kk] = res.quotes[ii];
+    }
+    return res;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * @file VolSurface.h
+ * @brief Batch construction of an implied volatility surface from a set of quotes.
+ */
+
+#pragma once
+
+#include "ImpliedVol.h"
+
+#include <vector>
+
+/**
+ * @brief Implied volatilities of a set of quotes on a strike by maturity grid.
+ *
+ * The grid is made of the distinct strikes and maturities of the quotes, in increasing order;
+ * points without a quote have a NaN volatility and the status `ImpliedVolStatus::NoQuote`. When
+ * several quotes fall on the same point, the grid keeps the result of the last one.
+ */
+struct VolSurfaceResult {
+    std::vector<double> strikes;            ///< Distinct strikes, in increasing order.
+    std::vector<double> maturities;         ///< Distinct maturities, in increasing order.
+    std::vector<ImpliedVolResult> points;   ///< Result of each point, maturity by maturity.
+    std::vector<ImpliedVolResult> quotes;   ///< Result of each quote, in the order of the input.
+
+    /**
+     * @brief Returns the diagnostics of one point of the grid.
+     * @param strike Index of the strike.
+     * @param maturity Index of the maturity.
+     * @return Implied volatility and convergence information.
+     */
+    const ImpliedVolResult& at(size_t strike, size_t maturity) const { return points[maturity * strikes.size() + strike]; }
+
+    /**
+     * @brief Returns the implied volatility of one point of the grid.
+     * @param strike Index of the strike.
+     * @param maturity Index of the maturity.
+     * @return Implied volatility, NaN if the point has no quote.
+     */
+    double vol(size_t strike, size_t maturity) const { return at(strike, maturity).vol; }
+};
+
+/**
+ * @class VolSurface
+ * @brief Implies the volatilities of many quotes at once, sharing the pricing work between them.
+ *
+ * Quotes with the same maturity, initial time, spot and exercise type have the same time mesh,
+ * spot mesh and curve lookups, so they are priced together: one `Option` is built per group and
+ * `Option::price_scenarios` prices all their scenarios in one call, each with its own strike,
+ * contract type and volatility. The Newton iterations of `ImpliedVol` run on the whole group at
+ * once, every active quote contributing its iterate and its vega bump to the same call; a quote
+ * leaves the batch when it converges. Quotes for which Newton fails are handed to
+ * `ImpliedVol::solve`, whose Brent search is run on them one at a time.
+ *
+ * Groups are split into chunks of at most `CHUNK` quotes, processed in parallel on
+ * `ThreadPool::global()`.
+ */
+class VolSurface {
+
+    unsigned int time_mesh_;
+    unsigned int spot_mesh_;
+    InterestRateHandle curve_;
+    PSORSettings psor_;
+    ImpliedVolSettings settings_;
+    ImpliedVol solver_;
+
+    void solve_group(const std::vector<VolQuote>& quotes, const size_t* index, size_t count, ImpliedVolResult* res) const;
+
+public:
+    /**
+     * @brief Maximum number of quotes priced together in one task.
+     */
+    static const size_t CHUNK = 32;
+
+    /**
+     * @brief Constructs the surface builder.
+     * @param time_mesh Number of time steps in the grid.
+     * @param spot_mesh Number of spot steps in the grid.
+     * @param rate_curve Shared, immutable interest rate curve.
+     * @param settings Parameters of the implied volatility search.
+     * @param psor Settings of the projected SOR solver used for American exercise.
+     */
+    VolSurface(unsigned int time_mesh, unsigned int spot_mesh, InterestRateHandle rate_curve,
+        const ImpliedVolSettings& settings = ImpliedVolSettings(), const PSORSettings& psor = PSORSettings());
+
+    /**
+     * @brief Computes the implied volatilities of a set of quotes and arranges them on a grid.
+     * @param quotes Option quotes.
+     * @return Strike by maturity grid of implied volatilities and per-quote results.
+     */
+    VolSurfaceResult build(const std::vector<VolQuote>& quotes) const;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Option.h"
+#include "ResultWriter.h"
 
-#include "Option.h"
+#include <iostream>
 
 int main() {
 
@@ -18,13 +19,10 @@ int main() {
 		unsigned int M = 500; //spot mesh
 
 		Option opt(ct, et, T, K, T0, N, M, S0, ir, sigma);
-		std::cout << std::fixed << std::setprecision(5);
-		std::cout << "Price: " << std::setw(5) << opt.price() << std::endl
-			<< "Delta: " << std::setw(5) << opt.delta(S0) << std::endl
-			<< "Gamma: " << std::setw(5) << opt.gamma() << std::endl
-			<< "Theta: " << std::setw(5) << opt.theta() << std::endl
-			<< "Vega:  " << std::setw(5) << opt.vega() << std::endl
-			<< "Rho:   " << std::setw(5) << opt.rho() << std::endl;
+		ResultWriter out("-", ResultFormat::CSV); //"-" writes to the standard output
+		TradeResult result = { 0, opt.price(), opt.delta(S0), opt.gamma(), opt.theta(), opt.vega(), opt.rho() };
+		out.push(result);
+		out.close();
 	}
 	catch (const OptionExceptions& e) {
 		std::cout << "Exception -> " << e.what();
@@ -0,0 +1,77 @@
+/**
+ * @file ArenaTest.cpp
+ * @brief Checks that scratch vectors allocated in an arena scope can be freed on another thread or after the scope.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -pthread -I.. ArenaTest.cpp ../Arena.cpp -o ArenaTest`.
+ * Returns 0 on success; building with `-fsanitize=address` also reports any invalid free.
+ */
+
+#include "Arena.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+int main() {
+    int failures = 0;
+
+    // A vector of the calling thread's arena, moved to a worker that grows it and destroys it.
+    ScratchVector moved;
+    {
+        ArenaScope scope;
+        ScratchVector v(1000, 1.0);
+        if (!Arena::local().owns(v.data())) {
+            std::fprintf(stderr, "FAILED: vector allocated in a scope is not in the arena\n");
+            failures++;
+        }
+        moved = std::move(v);
+        std::thread worker([&] {
+            ScratchVector local = std::move(moved);
+            local.resize(100000, 2.0);
+            if (local[999] != 1.0 || local[99999] != 2.0) {
+                std::fprintf(stderr, "FAILED: vector reallocated on another thread lost its values\n");
+                failures++;
+            }
+        });
+        worker.join();
+    }
+
+    // A vector allocated by a worker inside its own scope and freed by this thread, the way a result leaves a pool task.
+    ScratchVector returned;
+    std::atomic<int> stage(0);
+    std::thread worker([&] {
+        ArenaScope scope;
+        ScratchVector v(500, 3.0);
+        returned = std::move(v);
+        stage = 1;
+        while (stage != 2) std::this_thread::yield();
+    });
+    while (stage != 1) std::this_thread::yield();
+    if (returned.size() != 500 || returned.front() != 3.0) {
+        std::fprintf(stderr, "FAILED: vector moved out of a worker scope has the wrong values\n");
+        failures++;
+    }
+    returned = ScratchVector();
+    stage = 2;
+    worker.join();
+
+    // A vector freed on its own thread after its scope was reset, and a heap vector out of any scope.
+    ScratchVector late;
+    {
+        ArenaScope scope;
+        ScratchVector v(10, 4.0);
+        late.swap(v);
+    }
+    late.clear();
+    late.shrink_to_fit();
+    ScratchVector heap(10, 5.0);
+    if (Arena::local().owns(heap.data())) {
+        std::fprintf(stderr, "FAILED: vector allocated outside any scope is in the arena\n");
+        failures++;
+    }
+
+    if (failures == 0) std::printf("ArenaTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file BarrierTest.cpp
+ * @brief Checks the continuously monitored barrier options: knock-in plus knock-out equals the
+ * vanilla, and the knock-outs, with and without a rebate, match their closed forms.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. BarrierTest.cpp ../Option.cpp ../Tridiag.cpp ../InterestRate.cpp ../LocalVol.cpp ../ProjectedSOR.cpp ../ThreadPool.cpp ../Arena.cpp -o BarrierTest`.
+ * Returns 0 on success. The up barrier is not a multiple of the spot step, so the lowest node
+ * sits strictly between 0 and \( \Delta S \): an error of one node in the truncated domain, or in
+ * the offset \( j_0 \) of the spots, moves the prices far beyond the tolerances.
+ */
+
+#include "Option.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    const double r = 0.05;     ///< Flat short rate.
+    const double sigma = 0.25; ///< Flat volatility.
+    const unsigned steps = 400; ///< Number of time levels.
+
+    /// The payoff is set on the last of the `steps` levels, one step before the maturity of 1.
+    const double maturity = 1.0 - 1.0 / steps;
+
+    double cdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+    /**
+     * @brief Price of a knock-out with strike and spot 100, from the formulas of Reiner and
+     * Rubinstein, the rebate being paid when the barrier is hit.
+     * @param phi 1 for a call, -1 for a put.
+     * @param eta 1 for a down barrier, -1 for an up barrier.
+     * @param H Barrier level.
+     * @param rebate Rebate.
+     * @return Closed-form price.
+     */
+    double knock_out(int phi, int eta, double H, double rebate) {
+        double S = 100, X = 100, T = maturity;
+        double sT = sigma * std::sqrt(T), mu = (r - sigma * sigma / 2) / (sigma * sigma);
+        double lambda = std::sqrt(mu * mu + 2 * r / (sigma * sigma));
+        double x1 = std::log(S / X) / sT + (1 + mu) * sT, x2 = std::log(S / H) / sT + (1 + mu) * sT;
+        double y1 = std::log(H * H / (S * X)) / sT + (1 + mu) * sT, y2 = std::log(H / S) / sT + (1 + mu) * sT;
+        double z = std::log(H / S) / sT + lambda * sT;
+        double df = std::exp(-r * T), p = std::pow(H / S, 2 * mu), q = std::pow(H / S, 2 * (mu + 1));
+        double A = phi * S * cdf(phi * x1) - phi * X * df * cdf(phi * x1 - phi * sT);
+        double B = phi * S * cdf(phi * x2) - phi * X * df * cdf(phi * x2 - phi * sT);
+        double C = phi * S * q * cdf(eta * y1) - phi * X * df * p * cdf(eta * y1 - eta * sT);
+        double D = phi * S * q * cdf(eta * y2) - phi * X * df * p * cdf(eta * y2 - eta * sT);
+        double F = rebate * (std::pow(H / S, mu + lambda) * cdf(eta * z) + std::pow(H / S, mu - lambda) * cdf(eta * z - 2 * eta * lambda * sT));
+        // The strike is above a down barrier or below an up barrier: a call knocked out up has a capped payoff.
+        return (phi == 1 && eta == -1 ? A - B + C - D : A - C) + F;
+    }
+
+    /**
+     * @brief Compares a price with its reference.
+     * @param name Description of the case.
+     * @param price Price of the pricer.
+     * @param expected Reference price.
+     * @param tol Largest accepted difference.
+     * @return 1 if the prices differ by more than `tol`, 0 otherwise.
+     */
+    int check(const char* name, double price, double expected, double tol) {
+        if (std::fabs(price - expected) > tol) {
+            std::fprintf(stderr, "FAILED: %s, %.8f instead of %.8f\n", name, price, expected);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main() {
+    int failures = 0;
+    InterestRateHandle rates = std::make_shared<const InterestRate>(std::vector<std::pair<double, double>>{ { 0, r } });
+    auto price = [&](int contract_type, const Barrier& barrier) {
+        return Option(contract_type, 1, 1, 100, 0, steps, 400, 100, rates, sigma, PSORSettings(), 0, {}, nullptr, nullptr, barrier).price();
+    };
+
+    // In-out parity: the knock-in grid extends the knock-out domain to the vanilla one.
+    double call = price(1, Barrier());
+    double put = price(-1, Barrier());
+    failures += check("down-and-in plus down-and-out call", price(1, Barrier(BarrierType::DownIn, 90)) + price(1, Barrier(BarrierType::DownOut, 90)), call, 5e-3);
+    failures += check("up-and-in plus up-and-out put", price(-1, Barrier(BarrierType::UpIn, 117.3)) + price(-1, Barrier(BarrierType::UpOut, 117.3)), put, 5e-3);
+
+    failures += check("down-and-out call", price(1, Barrier(BarrierType::DownOut, 90)), knock_out(1, 1, 90, 0), 2e-3);
+    failures += check("down-and-out call with a rebate", price(1, Barrier(BarrierType::DownOut, 90, 3)), knock_out(1, 1, 90, 3), 2e-3);
+    failures += check("up-and-out put", price(-1, Barrier(BarrierType::UpOut, 117.3)), knock_out(-1, -1, 117.3, 0), 2e-3);
+    failures += check("up-and-out call", price(1, Barrier(BarrierType::UpOut, 117.3)), knock_out(1, -1, 117.3, 0), 2e-3);
+    failures += check("up-and-out put with a rebate", price(-1, Barrier(BarrierType::UpOut, 117.3, 2)), knock_out(-1, -1, 117.3, 2), 2e-3);
+
+    if (failures == 0) std::printf("BarrierTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/**
+ * @file DividendTest.cpp
+ * @brief Checks that an ex-dividend date or an exercise date between two time levels is kept
+ * exactly: the price is continuous in the date across a level, and smooth in the number of levels.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. DividendTest.cpp ../Option.cpp ../Tridiag.cpp ../InterestRate.cpp ../LocalVol.cpp ../ProjectedSOR.cpp ../ThreadPool.cpp ../Arena.cpp -o DividendTest`.
+ * Returns 0 on success. Snapping the date to a level would move the price by a jump of the order
+ * of \( \Delta T \) times the theta, far above the tolerances.
+ */
+
+#include "Option.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    /**
+     * @brief Compares the price with a date on a level with the prices with the date just before and just after it.
+     * @param name Description of the case.
+     * @param price Price as a function of the shift of the date.
+     * @param tol Largest accepted difference.
+     * @return 1 if a price differs by more than `tol`, 0 otherwise.
+     */
+    template <typename Price>
+    int continuous(const char* name, Price price, double tol) {
+        double on = price(0.0), before = price(-1e-6), after = price(1e-6);
+        if (std::fabs(before - on) > tol || std::fabs(after - on) > tol) {
+            std::fprintf(stderr, "FAILED: %s, %.12f on the level, %.12f before it, %.12f after it\n", name, on, before, after);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main() {
+    int failures = 0;
+    InterestRateHandle rates = std::make_shared<const InterestRate>(std::vector<std::pair<double, double>>{ { 0, 0.05 } });
+
+    // With 100 steps a year, t = 0.3 is on a level; moved by 1e-6 it gets a stop.
+    for (int exercise_type : { 1, 0 }) {
+        failures += continuous(exercise_type == 1 ? "European put, ex-dividend date" : "American put, ex-dividend date", [&](double shift) {
+            return Option(-1, exercise_type, 1, 100, 0, 100, 400, 100, rates, 0.25, PSORSettings(), 0, { { 0.3 + shift, 3.0 } }).price();
+        }, 1e-6);
+    }
+    failures += continuous("Bermudan put, exercise dates", [&](double shift) {
+        return Option(-1, 0, 1, 100, 0, 100, 400, 100, rates, 0.25, PSORSettings(), 0, {}, nullptr, nullptr, Barrier(), { 0.3 + shift, 0.6 - shift }).price();
+    }, 1e-6);
+    failures += continuous("down-and-out call, monitoring times", [&](double shift) {
+        return Option(1, 1, 1, 100, 0, 100, 400, 100, rates, 0.25, PSORSettings(), 0, {}, nullptr, nullptr,
+            Barrier(BarrierType::DownOut, 90, 0, { 0.25 + shift, 0.5 + shift, 0.75 + shift })).price();
+    }, 1e-5);
+
+    // The date falls on a level for one mesh in several: the prices converge smoothly in the
+    // number of steps instead of jumping with the distance from the date to the nearest level.
+    double prices[6];
+    for (unsigned ii = 0; ii < 6; ii++) {
+        prices[ii] = Option(-1, 1, 1, 100, 0, 98 + ii, 400, 100, rates, 0.25, PSORSettings(), 0, { { 0.3, 3.0 } }).price();
+    }
+    for (unsigned ii = 1; ii + 1 < 6; ii++) {
+        double curvature = prices[ii + 1] - 2 * prices[ii] + prices[ii - 1];
+        if (std::fabs(curvature) > 1e-5) {
+            std::fprintf(stderr, "FAILED: European put with %u steps off the trend by %.3e\n", 98 + ii, curvature);
+            failures++;
+        }
+    }
+
+    if (failures == 0) std::printf("DividendTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
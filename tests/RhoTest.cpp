@@ -0,0 +1,62 @@
+/**
+ * @file RhoTest.cpp
+ * @brief Checks the bump of `Option::rho`: relative to the first rate of the curve, and absolute
+ * for a curve whose first rate is 0.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. RhoTest.cpp ../Option.cpp ../Tridiag.cpp ../InterestRate.cpp ../LocalVol.cpp ../ProjectedSOR.cpp ../ThreadPool.cpp ../Arena.cpp -o RhoTest`.
+ * Returns 0 on success.
+ */
+
+#include "Option.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    /**
+     * @brief Prices a European call on a curve shifted in parallel.
+     * @param points Points of the curve.
+     * @param shift Parallel shift of the rates.
+     * @return Price of the call.
+     */
+    double price(std::vector<std::pair<double, double>> points, double shift) {
+        for (std::pair<double, double>& point : points) {
+            point.second += shift;
+        }
+        return Option(1, 1, 1, 100, 0, 200, 300, 100, std::make_shared<const InterestRate>(std::move(points)), 0.2).price();
+    }
+
+    /**
+     * @brief Compares the rho of a European call with the finite difference of the prices for a given shift.
+     * @param name Description of the curve.
+     * @param points Points of the curve.
+     * @param h Argument of `rho`.
+     * @param shift Expected shift of the curve.
+     * @return 1 if rho is not finite or differs from the finite difference, 0 otherwise.
+     */
+    int check(const char* name, const std::vector<std::pair<double, double>>& points, double h, double shift) {
+        Option option(1, 1, 1, 100, 0, 200, 300, 100, std::make_shared<const InterestRate>(points), 0.2);
+        double rho = option.rho(h);
+        double expected = (price(points, shift) - price(points, 0)) / shift;
+        if (!std::isfinite(rho) || std::fabs(rho - expected) > 1e-9 * std::fabs(expected)) {
+            std::fprintf(stderr, "FAILED: %s, rho %.12f instead of %.12f\n", name, rho, expected);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main() {
+    int failures = 0;
+    std::vector<std::pair<double, double>> curve = { { 0, 0.03 }, { 0.5, 0.035 }, { 1, 0.04 } };
+    std::vector<std::pair<double, double>> zero_start = { { 0, 0 }, { 0.5, 0.035 }, { 1, 0.04 } };
+
+    failures += check("curve starting at 3%", curve, 0.01, 0.01 * 0.03);
+    failures += check("curve starting at 0", zero_start, 1e-4, 1e-4);
+
+    if (failures == 0) std::printf("RhoTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
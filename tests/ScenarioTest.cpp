@@ -0,0 +1,80 @@
+/**
+ * @file ScenarioTest.cpp
+ * @brief Checks that the lock-step pricing of scenarios gives, bit for bit, the prices of the scenarios priced alone.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. ScenarioTest.cpp ../Option.cpp ../Tridiag.cpp ../InterestRate.cpp ../LocalVol.cpp ../ProjectedSOR.cpp ../ThreadPool.cpp ../Arena.cpp -o ScenarioTest`.
+ * Returns 0 on success. The mesh is below the size from which `Tridiag::solver` partitions a solve.
+ */
+
+#include "Option.h"
+
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    /**
+     * @brief Compares the prices of a batch with reference prices, reporting the first mismatch.
+     * @param name Description of the batch.
+     * @param prices Prices of the batch.
+     * @param expected Reference prices.
+     * @return 1 if a price differs, 0 otherwise.
+     */
+    int compare(const char* name, const std::vector<double>& prices, const std::vector<double>& expected) {
+        for (size_t ii = 0; ii < prices.size(); ii++) {
+            if (prices[ii] != expected[ii]) {
+                std::fprintf(stderr, "FAILED: %s, scenario %zu: %.17g instead of %.17g\n", name, ii, prices[ii], expected[ii]);
+                return 1;
+            }
+        }
+        return 0;
+    }
+}
+
+int main() {
+    int failures = 0;
+    InterestRateHandle rates = std::make_shared<const InterestRate>(std::vector<std::pair<double, double>>{ { 0, 0.03 }, { 0.5, 0.035 }, { 1, 0.04 } });
+    InterestRateHandle yield = std::make_shared<const InterestRate>(std::vector<std::pair<double, double>>{ { 0, 0.01 } });
+
+    // European vol ladder against a fresh option per volatility.
+    std::vector<double> vols = { 0.1, 0.15, 0.2, 0.25, 0.3, 0.45 };
+    Option european(1, 1, 1, 100, 0, 200, 300, 100, rates, 0.2, PSORSettings(), 0, {}, yield);
+    std::vector<double> expected;
+    for (double vol : vols) {
+        expected.push_back(Option(1, 1, 1, 100, 0, 200, 300, 100, rates, vol, PSORSettings(), 0, {}, yield).price());
+    }
+    failures += compare("European vol ladder", european.vol_ladder(vols), expected);
+
+    // Scenarios mixing contract types, strikes and volatilities, with cash dividends and Bermudan exercise.
+    std::vector<Dividend> dividends = { { 0.3, 1.5 }, { 0.7, 2.0 } };
+    std::vector<double> dates = { 0.25, 0.5, 0.75 };
+    std::vector<Scenario> scenarios = { { -1, 100, 0.2 }, { 1, 110, 0.3 }, { -1, 90, 0.3 }, { 1, 95, 0.2 }, { -1, 120, 0.35 } };
+    Option bermudan(-1, 0, 1, 100, 0, 200, 300, 100, rates, 0.2, PSORSettings(), 0, dividends, nullptr, nullptr, Barrier(), dates);
+    expected.clear();
+    for (const Scenario& sc : scenarios) {
+        expected.push_back(Option(sc.contract_type, 0, 1, sc.K, 0, 200, 300, 100, rates, sc.volatility, PSORSettings(), 0, dividends, nullptr, nullptr, Barrier(), dates).price());
+    }
+    failures += compare("Bermudan scenarios with dividends", bermudan.price_scenarios(scenarios), expected);
+
+    // With 301 levels the dividends and the exercise dates fall between two levels: the lanes take the same sub-steps.
+    Option split(-1, 0, 1, 100, 0, 301, 300, 100, rates, 0.2, PSORSettings(), 0, dividends, nullptr, nullptr, Barrier(), dates);
+    expected.clear();
+    for (const Scenario& sc : scenarios) {
+        expected.push_back(Option(sc.contract_type, 0, 1, sc.K, 0, 301, 300, 100, rates, sc.volatility, PSORSettings(), 0, dividends, nullptr, nullptr, Barrier(), dates).price());
+    }
+    failures += compare("Bermudan scenarios with dates between levels", split.price_scenarios(scenarios), expected);
+
+    // Under a local volatility surface each scenario scales the surface; priced alone, a scenario takes its own solve.
+    LocalVolHandle surface = std::make_shared<const LocalVol>(std::vector<double>{ 50, 100, 200 }, std::vector<double>{ 0, 1, 2 },
+        std::vector<double>{ 0.3, 0.25, 0.2, 0.28, 0.22, 0.18, 0.25, 0.2, 0.15 });
+    Option local(1, 1, 1, 100, 0, 200, 300, 100, rates, surface);
+    expected.clear();
+    for (const Scenario& sc : scenarios) {
+        expected.push_back(local.price_scenarios({ sc })[0]);
+    }
+    failures += compare("local volatility scenarios", local.price_scenarios(scenarios), expected);
+
+    if (failures == 0) std::printf("ScenarioTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file ScheduleTest.cpp
+ * @brief Checks the options with a schedule: a Bermudan put against a quadrature over its exercise
+ * date, and discretely monitored barriers against the continuity correction of Broadie, Glasserman
+ * and Kou.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. ScheduleTest.cpp ../Option.cpp ../Tridiag.cpp ../InterestRate.cpp ../LocalVol.cpp ../ProjectedSOR.cpp ../ThreadPool.cpp ../Arena.cpp -o ScheduleTest`.
+ * Returns 0 on success. One exercise date and the monitoring times fall between two time levels,
+ * where the sweep takes sub-steps.
+ */
+
+#include "Option.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+    const double r = 0.05;      ///< Flat short rate.
+    const double sigma = 0.25;  ///< Flat volatility.
+    const unsigned steps = 400; ///< Number of time levels.
+
+    /// The payoff is set on the last of the `steps` levels, one step before the maturity of 1.
+    const double maturity = 1.0 - 1.0 / steps;
+
+    double cdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+    /**
+     * @brief Black-Scholes price of a put with strike 100.
+     * @param S Spot.
+     * @param T Time to maturity.
+     * @return Put price.
+     */
+    double put(double S, double T) {
+        if (T <= 0) return std::max(100 - S, 0.0);
+        double sT = sigma * std::sqrt(T), d1 = (std::log(S / 100) + (r + sigma * sigma / 2) * T) / sT;
+        return 100 * std::exp(-r * T) * cdf(sT - d1) - S * cdf(-d1);
+    }
+
+    /**
+     * @brief Price of a put with strike and spot 100 exercisable at maturity and at one earlier date:
+     * the discounted expectation of \( \max(K - S_t, P(S_t, T - t)) \), by the midpoint rule over the
+     * normal variable of \( S_t \).
+     * @param t Exercise date.
+     * @return Bermudan put price.
+     */
+    double bermudan(double t) {
+        const int n = 20000;
+        const double width = 16.0 / n;
+        double sum = 0;
+        for (int ii = 0; ii < n; ii++) {
+            double z = -8 + (ii + 0.5) * width;
+            double S = 100 * std::exp((r - sigma * sigma / 2) * t + sigma * std::sqrt(t) * z);
+            sum += std::max(100 - S, put(S, maturity - t)) * std::exp(-z * z / 2) * width;
+        }
+        return std::exp(-r * t) * sum / std::sqrt(2 * std::acos(-1.0));
+    }
+
+    /**
+     * @brief Price of a continuously monitored knock-out with strike and spot 100, from the formulas of
+     * Reiner and Rubinstein, for a call knocked out below the strike or a put knocked out above it.
+     * @param phi 1 for a down-and-out call, -1 for an up-and-out put.
+     * @param H Barrier level.
+     * @return Closed-form price.
+     */
+    double knock_out(int phi, double H) {
+        double S = 100, X = 100, T = maturity;
+        double sT = sigma * std::sqrt(T), mu = (r - sigma * sigma / 2) / (sigma * sigma);
+        double x1 = std::log(S / X) / sT + (1 + mu) * sT, y1 = std::log(H * H / (S * X)) / sT + (1 + mu) * sT;
+        double df = std::exp(-r * T);
+        double A = phi * S * cdf(phi * x1) - phi * X * df * cdf(phi * x1 - phi * sT);
+        double C = phi * S * std::pow(H / S, 2 * (mu + 1)) * cdf(phi * y1) - phi * X * df * std::pow(H / S, 2 * mu) * cdf(phi * y1 - phi * sT);
+        return A - C;
+    }
+
+    /**
+     * @brief Compares a price with its reference.
+     * @param name Description of the case.
+     * @param price Price of the pricer.
+     * @param expected Reference price.
+     * @param tol Largest accepted difference.
+     * @return 1 if the prices differ by more than `tol`, 0 otherwise.
+     */
+    int check(const char* name, double price, double expected, double tol) {
+        if (std::fabs(price - expected) > tol) {
+            std::fprintf(stderr, "FAILED: %s, %.8f instead of %.8f\n", name, price, expected);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main() {
+    int failures = 0;
+    InterestRateHandle rates = std::make_shared<const InterestRate>(std::vector<std::pair<double, double>>{ { 0, r } });
+    auto price = [&](int contract_type, int exercise_type, const Barrier& barrier, const std::vector<double>& dates) {
+        return Option(contract_type, exercise_type, 1, 100, 0, steps, 400, 100, rates, sigma, PSORSettings(), 0, {}, nullptr, nullptr, barrier, dates).price();
+    };
+
+    // Exercise dates on a level and between two levels.
+    for (double t : { 0.5, 0.3337 }) {
+        failures += check(t == 0.5 ? "Bermudan put, date on a level" : "Bermudan put, date between two levels",
+            price(-1, 0, Barrier(), { t }), bermudan(t), 5e-3);
+    }
+    double european = price(-1, 1, Barrier(), {});
+    double american = price(-1, 0, Barrier(), {});
+    double monthly = price(-1, 0, Barrier(), { 1.0 / 12, 2.0 / 12, 3.0 / 12, 4.0 / 12, 5.0 / 12, 6.0 / 12, 7.0 / 12, 8.0 / 12, 9.0 / 12, 10.0 / 12, 11.0 / 12 });
+    if (!(european < monthly && monthly < american)) {
+        std::fprintf(stderr, "FAILED: monthly Bermudan put %.8f not between the European %.8f and the American %.8f\n", monthly, european, american);
+        failures++;
+    }
+
+    // Monthly monitoring: the discrete barrier is priced as a continuous one moved away from the
+    // spot by \( e^{0.5826 \sigma \sqrt{\Delta t}} \).
+    std::vector<double> monitoring;
+    for (int kk = 1; kk <= 12; kk++) {
+        monitoring.push_back(kk * maturity / 12);
+    }
+    double shift = std::exp(0.5826 * sigma * std::sqrt(maturity / 12));
+    failures += check("discrete down-and-out call", price(1, 1, Barrier(BarrierType::DownOut, 90, 0, monitoring), {}), knock_out(1, 90 / shift), 1e-2);
+    failures += check("discrete up-and-out put", price(-1, 1, Barrier(BarrierType::UpOut, 115, 0, monitoring), {}), knock_out(-1, 115 * shift), 1e-2);
+    failures += check("discrete down-and-in plus down-and-out call",
+        price(1, 1, Barrier(BarrierType::DownIn, 90, 0, monitoring), {}) + price(1, 1, Barrier(BarrierType::DownOut, 90, 0, monitoring), {}),
+        price(1, 1, Barrier(), {}), 5e-3);
+
+    if (failures == 0) std::printf("ScheduleTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+/**
+ * @file SolverTest.cpp
+ * @brief Checks the linear solvers against their serial references: the red-black PSOR against
+ * Gauss-Seidel, the partitioned (SPIKE) tridiagonal solve against Thomas, and the restart of a
+ * diverging PSOR solve.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -O2 -pthread -I.. SolverTest.cpp ../ProjectedSOR.cpp ../Tridiag.cpp ../ThreadPool.cpp ../Arena.cpp -o SolverTest`.
+ * Returns 0 on success. The partitioned solve only splits the system when the global pool has
+ * more than one thread; on a single core it is compared in its Thomas fallback.
+ */
+
+#include "ProjectedSOR.h"
+#include "ThreadPool.h"
+#include "Tridiag.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+    /**
+     * @brief Builds the implicit matrix of a Crank-Nicolson step on a uniform grid,
+     * \( \text{Tridiag}(-a_j, 1 + b_j, -c_j) \) with node-dependent coefficients.
+     * @param n Number of unknowns.
+     * @param dt Time step, scaling the coefficients.
+     * @return Diagonally dominant tridiagonal matrix.
+     */
+    Tridiag scheme(size_t n, double dt) {
+        ScratchVector l(n - 1), d(n), u(n - 1);
+        for (size_t jj = 0; jj < n; jj++) {
+            double s2 = 0.04 * (jj + 1.0) * (jj + 1.0);
+            double r = 0.03 * (jj + 1.0);
+            d[jj] = 1 + 0.5 * dt * (s2 + 0.03);
+            if (jj > 0) l[jj - 1] = -0.25 * dt * (s2 - r);
+            if (jj + 1 < n) u[jj] = -0.25 * dt * (s2 + r);
+        }
+        return Tridiag(std::move(l), std::move(d), std::move(u));
+    }
+
+    /**
+     * @brief Returns the largest absolute difference between two vectors.
+     * @param x First vector.
+     * @param y Second vector, of the same size.
+     * @return Maximum norm of the difference.
+     */
+    double distance(const ScratchVector& x, const ScratchVector& y) {
+        double d = 0;
+        for (size_t ii = 0; ii < x.size(); ii++) {
+            d = std::max(d, std::fabs(x[ii] - y[ii]));
+        }
+        return d;
+    }
+}
+
+int main() {
+    int failures = 0;
+
+    // An American put step: obstacle max(K - S, 0), right-hand side from the continuation value.
+    // Both orderings converge to the unique solution of the complementarity problem.
+    size_t n = 20000;
+    Tridiag C = scheme(n, 1e-4);
+    ScratchVector b(n), g(n);
+    for (size_t jj = 0; jj < n; jj++) {
+        double S = 0.01 * (jj + 1.0);
+        g[jj] = std::max(100.0 - S, 0.0);
+        b[jj] = std::max(100.0 - S, 0.0) * 0.999 + 0.5 * std::exp(-0.5 * (S - 100.0) * (S - 100.0));
+    }
+    ScratchVector gs(g), rb(g);
+    ProjectedSOR gauss_seidel(PSORSettings(1e-13, 1.2, PSOROrdering::GaussSeidel, 10000, PSOROmega::Fixed, false));
+    ProjectedSOR red_black(PSORSettings(1e-13, 1.2, PSOROrdering::RedBlack, 10000, PSOROmega::Fixed, false));
+    PSORStats gs_stats = gauss_seidel.solve(C, b, g, gs);
+    PSORStats rb_stats = red_black.solve(C, b, g, rb);
+    double psor = distance(gs, rb);
+    if (gs_stats.status != PSORStatus::Converged || rb_stats.status != PSORStatus::Converged || psor > 1e-10) {
+        std::fprintf(stderr, "FAILED: red-black PSOR differs from Gauss-Seidel by %.3e (statuses %d, %d)\n",
+            psor, (int)gs_stats.status, (int)rb_stats.status);
+        failures++;
+    }
+
+    // The partitioned solve is exact up to rounding: compare it with Thomas on a system large
+    // enough to be split in several blocks.
+    size_t m = 100000;
+    Tridiag A = scheme(m, 1e-4);
+    ScratchVector rhs(m);
+    for (size_t jj = 0; jj < m; jj++) {
+        rhs[jj] = std::sin(0.001 * jj) + 1.0;
+    }
+    ScratchVector thomas = A.solve(rhs, TridiagSolver::Thomas);
+    ScratchVector spike = A.solve(rhs, TridiagSolver::Partitioned);
+    double scale = 0;
+    for (double x : thomas) scale = std::max(scale, std::fabs(x));
+    double partitioned = distance(thomas, spike);
+    if (partitioned > 1e-12 * scale) {
+        std::fprintf(stderr, "FAILED: partitioned solve differs from Thomas by %.3e\n", partitioned);
+        failures++;
+    }
+
+    // Over-relaxing a weakly dominant matrix with w = 1.99 makes the updates grow: the solver
+    // restarts from the initial guess with w = 1, keeps that value, and converges.
+    size_t k = 50;
+    Tridiag W(ScratchVector(k - 1, -0.45), ScratchVector(k, 1.0), ScratchVector(k - 1, -0.45));
+    ScratchVector ones(k, 1.0), zeros(k, 0.0), x(k, 0.0);
+    ProjectedSOR restart(PSORSettings(1e-12, 1.99, PSOROrdering::GaussSeidel, 10000, PSOROmega::Fixed, false, 4000, 1.01));
+    PSORStats restart_stats = restart.solve(W, ones, zeros, x);
+    double residual = 0;
+    for (size_t ii = 0; ii < k; ii++) {
+        double Wx = x[ii] - 0.45 * ((ii > 0 ? x[ii - 1] : 0.0) + (ii + 1 < k ? x[ii + 1] : 0.0));
+        residual = std::max(residual, std::fabs(std::min(x[ii], Wx - 1.0)));
+    }
+    if (restart_stats.status != PSORStatus::Converged || restart_stats.omega != 1.0 || restart.omega() != 1.0 || residual > 1e-9) {
+        std::fprintf(stderr, "FAILED: diverging PSOR solve was not restarted (status %d, omega %.2f, residual %.3e)\n",
+            (int)restart_stats.status, restart_stats.omega, residual);
+        failures++;
+    }
+
+    // Without diagonal dominance the restart diverges as well: the status says so and the
+    // solution is the best finite iterate instead of the overflowing one.
+    Tridiag N(ScratchVector(k - 1, -0.6), ScratchVector(k, 1.0), ScratchVector(k - 1, -0.6));
+    ScratchVector y(k, 0.0);
+    ProjectedSOR diverging(PSORSettings(1e-12, 1.99, PSOROrdering::GaussSeidel, 10000, PSOROmega::Fixed, false, 400, 100));
+    PSORStats diverging_stats = diverging.solve(N, ones, zeros, y);
+    bool finite = std::all_of(y.begin(), y.end(), [](double v) { return std::isfinite(v); });
+    if (diverging_stats.status != PSORStatus::Diverged || diverging_stats.sweeps > 400 || !finite) {
+        std::fprintf(stderr, "FAILED: diverging restart returned status %d after %zu sweeps\n",
+            (int)diverging_stats.status, diverging_stats.sweeps);
+        failures++;
+    }
+
+    if (failures == 0) std::printf("SolverTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
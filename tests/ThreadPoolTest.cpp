@@ -0,0 +1,89 @@
+/**
+ * @file ThreadPoolTest.cpp
+ * @brief Checks that batches submitted from inside a task, on a worker or on the submitting thread, run to completion,
+ * and that a small batch only involves the threads it needs.
+ *
+ * Standalone program, built apart from the main project:
+ * `g++ -std=c++14 -pthread -I.. ThreadPoolTest.cpp ../ThreadPool.cpp -o ThreadPoolTest`.
+ * Returns 0 on success; a deadlock is reported by a watchdog after 10 seconds.
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <thread>
+
+int main() {
+    std::thread([] {
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+        std::fprintf(stderr, "FAILED: nested submission deadlocked\n");
+        std::_Exit(1);
+    }).detach();
+
+    int failures = 0;
+
+    // Every outer task submits an inner batch to the same pool, including the tasks taken by the submitting thread.
+    ThreadPool pool(4);
+    std::atomic<size_t> inner(0);
+    pool.run(8, [&](size_t) {
+        pool.run(4, [&](size_t) { inner++; });
+    });
+    if (inner != 32) {
+        std::fprintf(stderr, "FAILED: nested run executed %zu inner tasks, expected 32\n", inner.load());
+        failures++;
+    }
+
+    // Nested parallel_for on the global pool, the shape of a batch pricing whose pricings split their own loops.
+    std::atomic<size_t> covered(0);
+    ThreadPool::global().parallel_for(0, 64, [&](size_t lo, size_t hi) {
+        for (size_t ii = lo; ii < hi; ii++) {
+            ThreadPool::global().parallel_for(0, 100, [&](size_t a, size_t b) { covered += b - a; });
+        }
+    });
+    if (covered != 6400) {
+        std::fprintf(stderr, "FAILED: nested parallel_for covered %zu indices, expected 6400\n", covered.load());
+        failures++;
+    }
+
+    // The flag is restored once the batch is over: a later batch from the same thread is parallel again.
+    std::atomic<size_t> threads_seen(0);
+    std::atomic<bool> other(false);
+    std::thread::id self = std::this_thread::get_id();
+    pool.run(64, [&](size_t) {
+        threads_seen++;
+        if (std::this_thread::get_id() != self) other = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    if (threads_seen != 64 || !other) {
+        std::fprintf(stderr, "FAILED: batch after a nested submission did not reach the workers\n");
+        failures++;
+    }
+
+    // A batch of two tasks on a large pool seats one worker: at most two threads ever run its tasks.
+    ThreadPool wide(8);
+    size_t most = 0;
+    std::atomic<size_t> done(0);
+    for (int rep = 0; rep < 2000; rep++) {
+        std::mutex seen_mutex;
+        std::set<std::thread::id> seen;
+        wide.run(2, [&](size_t) {
+            std::lock_guard<std::mutex> lock(seen_mutex);
+            seen.insert(std::this_thread::get_id());
+            done++;
+        });
+        most = std::max(most, seen.size());
+    }
+    if (done != 4000 || most > 2) {
+        std::fprintf(stderr, "FAILED: two-task batches ran %zu tasks on up to %zu threads\n", done.load(), most);
+        failures++;
+    }
+
+    if (failures == 0) std::printf("ThreadPoolTest passed\n");
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file